@@ -1,5 +1,7 @@
-from .bindings import Compressor, Dependency
+from .bindings import Compressor, Dependency, CancelToken, Cancelled
 
+import queue
+import threading
 import tkinter as tk
 from matplotlib.backends.backend_tkagg import FigureCanvasTkAgg
 from matplotlib.figure import Figure
@@ -57,12 +59,21 @@ class MeasCompressGUI:
         self._root.wm_title("MeasCompress")
         # TODO size
 
+        self._status = tk.Label(self._root, anchor='w')
+        self._status.pack(side='bottom', fill='x')
+
         self._main = tk.Frame(self._root)
         self._main.pack(fill='both', expand=True)
 
         self.time = t
         self.meas = {}
 
+        # the fit runs in a background thread, results are passed to the
+        # tk main loop via the queue
+        self._cancel = None
+        self._queue = queue.Queue()
+        self._root.after(50, self._poll)
+
     def add(self, name, val, show=True, tol=None):
         fig = Figure(figsize=(1, 0.2), dpi=100)
         ax = fig.subplots(nrows=1, ncols=1)
@@ -117,11 +128,56 @@ class MeasCompressGUI:
                if m.tol is not None]
         if len(dep) == 0:
             raise Exception('no dependency defined')
-        comp = Compressor().Fit(self.time, dep)
 
-        t = comp.GetTimeFit()
-        for m in self.meas.values():
-            y = comp.Transform(m.val)
+        # abort a stale fit
+        if self._cancel is not None:
+            self._cancel.Cancel()
+        cancel = CancelToken()
+        self._cancel = cancel
+
+        vals = {name: m.val for name, m in self.meas.items()}
+        thread = threading.Thread(target=self._fit_worker,
+                                  args=(cancel, dep, vals), daemon=True)
+        thread.start()
+
+    def _fit_worker(self, cancel, dep, vals):
+        def progress(done, total):
+            self._queue.put((cancel, 'progress', done / total))
+
+        try:
+            comp = Compressor().Fit(self.time, dep,
+                                    progress=progress, cancel=cancel)
+            t = comp.GetTimeFit()
+            ys = {name: comp.Transform(val, cancel=cancel)
+                  for name, val in vals.items()}
+        except Cancelled:
+            return
+        except Exception as error:  # pylint: disable=broad-except
+            # report to the GUI, the thread would end silently
+            self._queue.put((cancel, 'error', str(error)))
+            return
+        self._queue.put((cancel, 'result', (t, ys)))
+
+    def _poll(self):
+        while True:
+            try:
+                cancel, kind, data = self._queue.get_nowait()
+            except queue.Empty:
+                break
+            if cancel is not self._cancel:
+                continue  # message of a stale fit
+            if kind == 'progress':
+                self._status.config(text=f'fitting... {data:.0%}')
+            elif kind == 'error':
+                self._status.config(text=f'fit failed: {data}')
+            else:
+                self._show_fit(*data)
+        self._root.after(50, self._poll)
+
+    def _show_fit(self, t, ys):
+        self._status.config(text=f'{len(t)} of {len(self.time)} points')
+        for name, y in ys.items():
+            m = self.meas[name]
             m.line.set_xdata(t)
             m.line.set_ydata(y)
             m.fig.canvas.draw()
@@ -1,2 +1,2 @@
-from .bindings import Compressor, Dependency
+from .bindings import Compressor, Dependency, CancelToken, Cancelled, Residual
 from .MeasCompressGUI import MeasCompressGUI
@@ -1,14 +1,62 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <string>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
 #include "compressor.hpp"
 #include "dependency.hpp"
+#include "residual.hpp"
 
 namespace py = pybind11;
 
 using T = double;
-using Dependency = measCompress::Dependency<T>;
+using Dependency = measCompress::AnyDependency<T>;
 using Compressor = measCompress::Compressor<T>;
+using Residual = measCompress::Residual<T>;
+using measCompress::CancelToken;
+using measCompress::Progress;
+
+namespace
+{
+  Dependency make_dependency(std::vector<T> y, T tol,
+                             const std::string &norm, T rtol)
+  {
+    using namespace measCompress;
+    if (rtol != T(0) && norm != "absrel")
+      throw std::invalid_argument("rtol is only used with norm 'absrel'");
+    if (norm == "abs")
+      return measCompress::Dependency<T, AbsMaxError<T>>(std::move(y), tol);
+    if (norm == "rel")
+      return measCompress::Dependency<T, RelMaxError<T>>(std::move(y), tol);
+    if (norm == "rms")
+      return measCompress::Dependency<T, RmsError<T>>(std::move(y), tol);
+    if (norm == "absrel")
+      return measCompress::Dependency<T, AbsRelMaxError<T>>(
+          std::move(y), AbsRelMaxError<T>(tol, rtol));
+    throw std::invalid_argument("unknown norm '" + norm +
+                                "' (expected 'abs', 'rel', 'rms' or 'absrel')");
+  }
+
+  // The python callback is called with the GIL (the computation runs
+  // without). The Progress object must be created and destroyed with the GIL.
+  Progress make_progress(std::optional<py::function> callback,
+                         std::optional<CancelToken> cancel,
+                         std::size_t step)
+  {
+    if (!callback)
+      return cancel ? Progress(*cancel) : Progress();
+    return Progress(
+        [callback = std::move(*callback)](std::size_t done, std::size_t total)
+        {
+          py::gil_scoped_acquire gil;
+          callback(done, total);
+        },
+        step, std::move(cancel));
+  }
+} // namespace
 
 PYBIND11_MODULE(bindings, m)
 {
@@ -20,14 +68,174 @@ PYBIND11_MODULE(bindings, m)
     )doc";
 
   py::class_<Dependency>(m, "Dependency")
-      .def(py::init<std::vector<T>, T>()); // TODO docstring
+      .def(py::init(&make_dependency),
+           py::arg("y"), py::arg("tol"),
+           py::arg("norm") = "abs", py::arg("rtol") = T(0),
+           R"doc(
+             Dependency for a single timeseries
+
+             norm: 'abs' (max absolute error < tol, default),
+                   'rel' (|error| < tol * |y|),
+                   'rms' (root mean square error < tol),
+                   'absrel' (|error| < tol + rtol * |y|)
+           )doc");
+
+  py::class_<CancelToken>(m, "CancelToken")
+      .def(py::init<>())
+      .def("Cancel", &CancelToken::Cancel)
+      .def("IsCancelled", &CancelToken::IsCancelled);
+
+  py::register_exception<Compressor::Cancelled>(m, "Cancelled",
+                                                PyExc_RuntimeError);
 
   py::class_<Compressor>(m, "Compressor")
       .def(py::init<>())
-      .def("Fit", &Compressor::Fit)
+      .def(py::init<std::vector<T>, std::vector<std::size_t>>(),
+           py::arg("t"), py::arg("pos"),
+           "Fitted compressor from stored positions (see GetPos)")
+      .def_static("FromGrid", &Compressor::FromGrid,
+                  py::arg("t0"), py::arg("dt"), py::arg("n"), py::arg("pos"),
+                  "Fitted compressor on the time grid t_i = t0 + i * dt")
+      .def(
+          "Serialize",
+          [](const Compressor &self, bool with_time)
+          { return py::bytes(self.Serialize(with_time)); },
+          py::arg("with_time") = true)
+      .def_static(
+          "Deserialize",
+          [](const std::string &data, std::size_t max_grid_size)
+          { return Compressor::Deserialize(data, max_grid_size); },
+          py::arg("data"), py::arg("max_grid_size") = std::size_t(1) << 28)
+      .def_static(
+          "Deserialize",
+          [](const std::string &data, std::vector<T> t)
+          { return Compressor::Deserialize(data, std::move(t)); },
+          py::arg("data"), py::arg("t"))
+      .def(py::pickle(
+          [](const Compressor &self)
+          {
+            return py::make_tuple(py::bytes(self.Serialize()),
+                                  self.GetThreads(), self.GetParallelMinSize());
+          },
+          [](const py::tuple &state)
+          {
+            if (state.size() != 3)
+              throw std::runtime_error("invalid pickled Compressor");
+            // pickled data is trusted, the grid size is not limited
+            auto result = Compressor::Deserialize(
+                state[0].cast<std::string>(),
+                std::numeric_limits<std::size_t>::max());
+            result.SetParallel(state[1].cast<std::size_t>(),
+                               state[2].cast<std::size_t>());
+            return result;
+          }))
+      .def("SetParallel", &Compressor::SetParallel,
+           py::arg("n_threads"), py::arg("min_size") = std::size_t(1) << 16,
+           R"doc(
+             Check several end points of long segments in parallel
+
+             n_threads: number of threads (0: number of cores, 1: disabled)
+             min_size: minimal segment size for the parallel search
+           )doc")
+      .def("GetThreads", &Compressor::GetThreads)
+      .def("GetParallelMinSize", &Compressor::GetParallelMinSize)
+      .def(
+          "Fit",
+          [](Compressor &self, std::vector<T> t,
+             const std::vector<Dependency> &deps,
+             std::optional<py::function> progress,
+             std::optional<CancelToken> cancel,
+             std::size_t progress_step) -> Compressor &
+          {
+            const auto p = make_progress(std::move(progress),
+                                         std::move(cancel), progress_step);
+            py::gil_scoped_release release;
+            return self.Fit(std::move(t), deps, p);
+          },
+          py::arg("t"), py::arg("deps"),
+          py::arg("progress") = py::none(), py::arg("cancel") = py::none(),
+          py::arg("progress_step") = 65536,
+          R"doc(
+            Fit the compressed measurement
+
+            progress: callable(done, total), called every 'progress_step' samples
+            cancel: CancelToken, raises Cancelled if cancelled during the fit
+          )doc")
       .def("TransformNoFit", &Compressor::TransformNoFit)
-      .def("Transform", &Compressor::Transform)
+      .def(
+          "Transform",
+          [](const Compressor &self, const std::vector<T> &y,
+             std::optional<py::function> progress,
+             std::optional<CancelToken> cancel,
+             std::size_t progress_step)
+          {
+            const auto p = make_progress(std::move(progress),
+                                         std::move(cancel), progress_step);
+            py::gil_scoped_release release;
+            return self.Transform(y, p);
+          },
+          py::arg("y"),
+          py::arg("progress") = py::none(), py::arg("cancel") = py::none(),
+          py::arg("progress_step") = 65536)
+      .def(
+          "TransformContinuous",
+          [](const Compressor &self, const std::vector<T> &y,
+             std::optional<py::function> progress,
+             std::optional<CancelToken> cancel,
+             std::size_t progress_step)
+          {
+            const auto p = make_progress(std::move(progress),
+                                         std::move(cancel), progress_step);
+            py::gil_scoped_release release;
+            return self.TransformContinuous(y, p);
+          },
+          py::arg("y"),
+          py::arg("progress") = py::none(), py::arg("cancel") = py::none(),
+          py::arg("progress_step") = 65536)
+      .def(
+          "TransformContinuous",
+          [](const Compressor &self, const std::vector<std::vector<T>> &ys,
+             std::optional<py::function> progress,
+             std::optional<CancelToken> cancel,
+             std::size_t progress_step)
+          {
+            const auto p = make_progress(std::move(progress),
+                                         std::move(cancel), progress_step);
+            py::gil_scoped_release release;
+            return self.TransformContinuous(ys, p);
+          },
+          py::arg("ys"),
+          py::arg("progress") = py::none(), py::arg("cancel") = py::none(),
+          py::arg("progress_step") = 65536)
       .def("GetPos", &Compressor::GetPos)
       .def("GetTimeFit", &Compressor::GetTimeFit)
       .def("GetTimeOrigin", &Compressor::GetTimeOrigin); // TODO docstring
+
+  py::class_<Residual>(m, "Residual")
+      .def_static("Encode", &Residual::Encode,
+                  py::arg("comp"), py::arg("y"), py::arg("y_fit"),
+                  py::arg("max_error") = T(0), py::arg("n_threads") = 1,
+                  py::call_guard<py::gil_scoped_release>(),
+                  R"doc(
+                    Residuals between y and its compressed version y_fit
+
+                    max_error: allowed error of the decoded timeseries (0: lossless)
+                  )doc")
+      .def("Decode", &Residual::Decode,
+           py::arg("comp"), py::arg("y_fit"), py::arg("n_threads") = 1,
+           py::call_guard<py::gil_scoped_release>())
+      .def("GetBytes", &Residual::GetBytes)
+      .def("GetMaxError", &Residual::GetMaxError)
+      .def("Serialize", [](const Residual &self)
+           { return py::bytes(self.Serialize()); })
+      .def_static(
+          "Deserialize",
+          [](const std::string &data)
+          { return Residual::Deserialize(data); },
+          py::arg("data"))
+      .def(py::pickle(
+          [](const Residual &self)
+          { return py::bytes(self.Serialize()); },
+          [](const py::bytes &data)
+          { return Residual::Deserialize(std::string(data)); }));
 }
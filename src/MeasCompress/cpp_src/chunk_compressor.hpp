@@ -0,0 +1,194 @@
+#ifndef MEASCOMPRESS_CHUNK_COMPRESSOR_HPP
+#define MEASCOMPRESS_CHUNK_COMPRESSOR_HPP
+
+#include <vector>
+#include <optional>
+
+#include <string>
+#include <exception>
+
+#include "./compressor.hpp"
+#include "./dependency.hpp"
+
+namespace measCompress
+{
+    /**
+     * @brief Compresses a measurement table chunk by chunk
+     *
+     * Every chunk is fitted on its own, starting with the last row of the
+     * previous chunk. So the compressed chunks are joined without a gap and
+     * the shared row is returned only once (with the previous chunk). The
+     * boundaries of the chunks are always points of the compressed
+     * measurement.
+     *
+     * With the continuous transform, the least squares fit of a chunk keeps
+     * the returned values of the shared row. So the output is continuous,
+     * but it differs from the fit of the whole table at once.
+     *
+     * @tparam T double (default)
+     */
+    template <typename T = double>
+    class ChunkCompressor
+    {
+    public:
+        using Columns = std::vector<std::vector<T>>;
+
+    public:
+        /**
+        * @brief Base exceptions class
+        */
+        class Exception : public std::exception
+        {
+        public:
+            Exception(std::string data) : data(std::move(data)) {}
+            const char *what() const noexcept override
+            {
+                return data.c_str();
+            }
+
+        protected:
+            std::string data;
+        };
+
+        /**
+         * @brief Invalid sizes exception
+         *
+         * e.g. the number of columns is different to the number of tolerances
+         */
+        class InvalidSize : public Exception
+        {
+        public:
+            InvalidSize() : Exception("at least one column has an invalid dimension") {}
+        };
+
+        /**
+         * @brief Too few rows exception
+         *
+         * the table has less than 2 rows
+         */
+        class TooFewRows : public Exception
+        {
+        public:
+            TooFewRows() : Exception("need at least 2 rows") {}
+        };
+
+    public:
+        /**
+         * @brief Construct a new ChunkCompressor object
+         *
+         * @param tolerances tolerance per column (std::nullopt: the column is
+         *                   only transformed)
+         * @param time_index index of the time column
+         * @param continuous use Compressor::TransformContinuous instead of
+         *                   Compressor::Transform
+         */
+        ChunkCompressor(std::vector<std::optional<T>> tolerances,
+                        std::size_t time_index,
+                        bool continuous = false)
+            : tolerances(std::move(tolerances)),
+              time_index(time_index),
+              continuous(continuous)
+        {
+            if (time_index >= this->tolerances.size())
+            {
+                throw InvalidSize();
+            }
+        }
+
+        /**
+         * @brief Compress the next chunk
+         *
+         * @param chunk next rows of the table (column wise)
+         * @return Columns compressed rows (column wise)
+         */
+        Columns Compress(Columns chunk)
+        {
+            if (chunk.size() != tolerances.size())
+                throw InvalidSize();
+            for (const auto &column : chunk)
+                if (column.size() != chunk[time_index].size())
+                    throw InvalidSize();
+
+            const bool first = last_row.empty();
+            if (!first)
+            {
+                for (std::size_t i = 0; i < chunk.size(); ++i)
+                    chunk[i].insert(chunk[i].begin(), last_row[i]);
+            }
+            if (chunk[time_index].size() < 2)
+            {
+                if (first)
+                    throw TooFewRows();
+                return Columns(chunk.size());
+            }
+
+            last_row.resize(chunk.size());
+            for (std::size_t i = 0; i < chunk.size(); ++i)
+                last_row[i] = chunk[i].back();
+
+            std::vector<Dependency<T>> deps;
+            for (std::size_t i = 0; i < chunk.size(); ++i)
+                if (tolerances[i])
+                    deps.emplace_back(Dependency<T>(chunk[i], *tolerances[i]));
+
+            // the continuous transform needs all columns (including the time)
+            // to be the same size
+            Compressor<T> comp;
+            if (continuous)
+                comp.Fit(chunk[time_index], deps);
+            else
+                comp.Fit(std::move(chunk[time_index]), deps);
+
+            Columns result(chunk.size());
+            if (continuous)
+            {
+                // all columns share one factorization, the shared row is
+                // already returned and must not change
+                result = first ? comp.TransformContinuous(chunk)
+                               : comp.TransformContinuous(chunk, last_fit);
+            }
+            for (std::size_t i = 0; i < chunk.size(); ++i)
+            {
+                if (i == time_index)
+                    result[i] = comp.GetTimeFit();
+                else if (!continuous)
+                    result[i] = comp.Transform(chunk[i]);
+            }
+
+            last_fit.resize(result.size());
+            for (std::size_t i = 0; i < result.size(); ++i)
+                last_fit[i] = result[i].back();
+
+            // the first row is already returned with the previous chunk
+            if (!first)
+            {
+                for (auto &column : result)
+                    column.erase(column.begin());
+            }
+            return result;
+        }
+
+        /**
+         * @brief Check the end of the table
+         *
+         * Throws TooFewRows if no chunk was compressed (e.g. only a header),
+         * same as for a first chunk with a single row.
+         */
+        void Finish() const
+        {
+            if (last_row.empty())
+                throw TooFewRows();
+        }
+
+    private:
+        std::vector<std::optional<T>> tolerances;
+        std::size_t time_index;
+        bool continuous;
+        std::vector<T> last_row;
+        // compressed values of last_row (as returned)
+        std::vector<T> last_fit;
+    };
+
+} // namespace measCompress
+
+#endif
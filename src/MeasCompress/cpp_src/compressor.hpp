@@ -3,12 +3,22 @@
 
 #include <vector>
 #include <span>
+#include <future>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <optional>
+#include <cstring>
+#include <cstdint>
+#include <string_view>
 
 #include <string>
 #include <exception>
 
 #include "./line.hpp"
 #include "./dependency.hpp"
+#include "./tridiagonal.hpp"
+#include "./progress.hpp"
 
 namespace measCompress
 {
@@ -66,12 +76,91 @@ namespace measCompress
             DifferentSize() : Exception("'t' and 'y' must have the same size") {}
         };
 
+        /**
+         * @brief Cancelled exception
+         * 
+         * the computation was cancelled with a CancelToken
+         */
+        class Cancelled : public Exception
+        {
+        public:
+            Cancelled() : Exception("cancelled") {}
+        };
+
+        /**
+         * @brief Invalid positions exception
+         * 
+         * e.g. positions are not increasing or do not contain the first and
+         * last point
+         */
+        class InvalidPosition : public Exception
+        {
+        public:
+            InvalidPosition() : Exception("invalid positions of the compressed measurement") {}
+        };
+
+        /**
+         * @brief Invalid format exception
+         * 
+         * e.g. serialized data is truncated or from a different type T
+         */
+        class InvalidFormat : public Exception
+        {
+        public:
+            InvalidFormat() : Exception("invalid serialized compressor") {}
+        };
+
     public:
         /**
          * @brief Construct a new Compressor object
          */
         Compressor() = default;
 
+        /**
+         * @brief Construct a fitted Compressor object from stored positions
+         * 
+         * @param t_ x vector (or time vector) of the original measurement
+         * @param position_ positions of the compressed measurement (see GetPos)
+         */
+        Compressor(std::vector<T> t_, std::vector<std::size_t> position_)
+            : position(std::move(position_)),
+              t(std::move(t_))
+        {
+            if (t.size() < 2)
+                throw InvalidSize();
+            if (!valid_position(position, t.size()))
+                throw InvalidPosition();
+            detect_grid();
+        }
+
+        /**
+         * @brief Construct a fitted Compressor object on an equidistant grid
+         * 
+         * The time vector is t_i = t0 + i * dt, i = 0, ..., n - 1. Only t0
+         * and dt are serialized.
+         * 
+         * @param t0 first time
+         * @param dt time step
+         * @param n number of points of the original measurement
+         * @param position_ positions of the compressed measurement (see GetPos)
+         * @return Compressor 
+         */
+        static Compressor FromGrid(T t0, T dt, std::size_t n,
+                                   std::vector<std::size_t> position_)
+        {
+            if (n < 2)
+                throw InvalidSize();
+            if (!valid_position(position_, n))
+                throw InvalidPosition();
+            std::vector<T> t_(n);
+            for (std::size_t i = 0; i < n; ++i)
+                t_[i] = t0 + T(i) * dt;
+
+            Compressor result(std::move(t_), std::move(position_));
+            result.grid = {t0, dt};
+            return result;
+        }
+
         /**
          * @brief compute the new points of the compressed measurement
          * 
@@ -79,12 +168,23 @@ namespace measCompress
          * line. So only the begin and end points of the approxmated line will 
          * be saved in the compressed measurement.
          * 
+         * The cancellation is checked after every segment, a cancelled fit
+         * throws Cancelled and leaves the object in an unspecified state.
+         * 
+         * The dependencies are e.g. Dependency<T, Norm> with a single error
+         * norm (checked without any dispatch), or AnyDependency<T> to combine
+         * different error norms (default for a braced list).
+         * 
+         * @tparam Dep type of the dependencies
          * @param t_ x vector (or time vector) of the original measurement
          * @param deps depencies for compressing the measurement
+         * @param progress progress reporting and cancellation (optional)
          * @return Compressor& (reference to this object)
          */
+        template <typename Dep = AnyDependency<T>>
         Compressor &Fit(std::vector<T> t_,
-                        const std::vector<Dependency<T>> &deps)
+                        const std::vector<Dep> &deps,
+                        const Progress &progress = Progress())
         {
             const auto n = t_.size();
             if (n < 2)
@@ -96,6 +196,9 @@ namespace measCompress
             }
 
             t = std::move(t_);
+            detect_grid();
+            checked_points = 0;
+            critical_points = 0;
 
             position.clear();
             position.reserve(static_cast<std::size_t>(n * 0.1));
@@ -103,18 +206,44 @@ namespace measCompress
 
             std::size_t last_step = 64;
 
+            auto reporter = progress.Start();
             while (true)
             {
                 const auto i0 = position.back();
+                if (progress.IsCancelled())
+                    throw Cancelled();
                 const auto i1 = binary_search(deps, i0, last_step);
                 last_step = i1 - i0;
                 position.push_back(i1 - 1);
+                reporter.Update(i1, n);
                 if (i1 == t.size())
                     break;
             }
             return *this;
         }
 
+        /**
+         * @brief Check several end points of a segment in parallel
+         * 
+         * For long segments, Fit checks n_threads end points of a segment
+         * concurrently (a (n_threads + 1)-ary instead of a binary search).
+         * This reduces the latency per segment (see GetCriticalPoints) but
+         * needs more checks in total (see GetCheckedPoints), so it is only
+         * used if the checked intervall has at least min_size points.
+         * 
+         * @param n_threads number of threads (0: number of cores, 1: disabled (default))
+         * @param min_size minimal intervall size for the parallel search
+         * @return Compressor& (reference to this object)
+         */
+        Compressor &SetParallel(std::size_t n_threads_,
+                                std::size_t min_size = std::size_t(1) << 16)
+        {
+            n_threads = n_threads_ == 0 ? std::max(1u, std::thread::hardware_concurrency())
+                                        : n_threads_;
+            parallel_min_size = min_size;
+            return *this;
+        }
+
         /**
          * @brief Transform a timeseries to the compressed measurement without fitting
          * 
@@ -145,16 +274,22 @@ namespace measCompress
          * measurement.
          * 
          * @param y timeseries of the original measurement
+         * @param progress progress reporting and cancellation (optional)
          * @return std::vector<T> compressed version of y
          */
-        std::vector<T> Transform(const std::vector<T> &y) const
+        std::vector<T> Transform(const std::vector<T> &y,
+                                 const Progress &progress = Progress()) const
         {
             if (y.size() != t.size())
                 throw InvalidSize();
 
             std::vector<T> result(position.size());
+            auto reporter = progress.Start();
             for (std::size_t i = 0; i < position.size() - 1; ++i)
             {
+                if (progress.IsCancelled())
+                    throw Cancelled();
+
                 const auto i0 = position[i];
                 const auto i1 = position[i + 1] + 1;
                 const auto t_ = std::span<const T>(t.begin() + i0, t.begin() + i1);
@@ -166,10 +301,143 @@ namespace measCompress
 
                 result[i] = i == 0 ? y0 : (result[i] + y0) / 2;
                 result[i + 1] = y1;
+                reporter.Update(i1, y.size());
             }
             return result;
         }
 
+        /**
+         * @brief Transform a timeseries to the compressed measurement
+         * 
+         * Fits a continuous piecewise linear function with the breakpoints
+         * of the compressed measurement (least squares over all points).
+         * In contrast to Transform, the joints are not averaged.
+         * 
+         * The progress counts the samples of every pass over the points (one
+         * for the matrix and one per timeseries).
+         * 
+         * @param y timeseries of the original measurement
+         * @param progress progress reporting and cancellation (optional)
+         * @return std::vector<T> compressed version of y
+         */
+        std::vector<T> TransformContinuous(const std::vector<T> &y,
+                                           const Progress &progress = Progress()) const
+        {
+            return std::move(transform_continuous({&y}, nullptr, progress).front());
+        }
+
+        /**
+         * @brief Transform several timeseries to the compressed measurement
+         * 
+         * @see TransformContinuous. The normal equations of all timeseries
+         * share one tridiagonal matrix, which is factorized only once.
+         * 
+         * @param ys timeseries of the original measurement
+         * @param progress progress reporting and cancellation (optional)
+         * @return std::vector<std::vector<T>> compressed versions of ys
+         */
+        std::vector<std::vector<T>> TransformContinuous(const std::vector<std::vector<T>> &ys,
+                                                        const Progress &progress = Progress()) const
+        {
+            std::vector<const std::vector<T> *> ys_;
+            ys_.reserve(ys.size());
+            for (const auto &y : ys)
+                ys_.push_back(&y);
+            return transform_continuous(ys_, nullptr, progress);
+        }
+
+        /**
+         * @brief Transform several timeseries with given values at the first point
+         * 
+         * @see TransformContinuous. The first point is not fitted but set to
+         * first[i] (e.g. the value already computed for the previous part of
+         * a measurement), the other points are the least squares fit for it.
+         * 
+         * @param ys timeseries of the original measurement
+         * @param first values of the compressed timeseries at the first point
+         * @param progress progress reporting and cancellation (optional)
+         * @return std::vector<std::vector<T>> compressed versions of ys
+         */
+        std::vector<std::vector<T>> TransformContinuous(const std::vector<std::vector<T>> &ys,
+                                                        const std::vector<T> &first,
+                                                        const Progress &progress = Progress()) const
+        {
+            if (first.size() != ys.size())
+                throw InvalidSize();
+            std::vector<const std::vector<T> *> ys_;
+            ys_.reserve(ys.size());
+            for (const auto &y : ys)
+                ys_.push_back(&y);
+            return transform_continuous(ys_, &first, progress);
+        }
+
+        /**
+         * @brief Serialize the fitted state (native binary representation)
+         * 
+         * Contains the positions and (optional) the time vector, or only t0
+         * and dt if the time vector is an exact grid t_i = t0 + i * dt (see
+         * FromGrid, also detected by Fit). Without the time, the data stays
+         * small for any time vector, restore it with Deserialize(data, t).
+         * A Compressor which is not fitted is serialized without positions.
+         * 
+         * @param with_time include the time vector
+         * @return std::string serialized data
+         */
+        std::string Serialize(bool with_time = true) const
+        {
+            const std::uint32_t flags = !with_time || position.empty() ? 0
+                                        : grid                         ? flag_grid
+                                                                       : flag_time;
+
+            std::string data;
+            auto write = [&data](const void *ptr, std::size_t size)
+            {
+                data.append(static_cast<const char *>(ptr), size);
+            };
+            const std::uint32_t header[] = {magic, version, sizeof(T), flags};
+            const std::uint64_t sizes[] = {t.size(), position.size()};
+            write(header, sizeof(header));
+            write(sizes, sizeof(sizes));
+            for (const std::uint64_t pos : position)
+                write(&pos, sizeof(pos));
+            if (flags == flag_grid)
+            {
+                write(&grid->first, sizeof(T));
+                write(&grid->second, sizeof(T));
+            }
+            else if (flags == flag_time)
+                write(t.data(), t.size() * sizeof(T));
+            return data;
+        }
+
+        /**
+         * @brief Deserialize a fitted Compressor (see Serialize)
+         * 
+         * The time vector of a grid is created with the stored number of
+         * points, which is limited to protect against corrupt data.
+         * 
+         * @param data serialized data, including the time
+         * @param max_grid_size maximal number of points of a grid
+         * @return Compressor 
+         */
+        static Compressor Deserialize(std::string_view data,
+                                      std::size_t max_grid_size = std::size_t(1) << 28)
+        {
+            return deserialize(data, std::nullopt, max_grid_size);
+        }
+
+        /**
+         * @brief Deserialize a fitted Compressor (see Serialize)
+         * 
+         * @param data serialized data (the time is ignored)
+         * @param t_ x vector (or time vector) of the original measurement
+         * @return Compressor 
+         */
+        static Compressor Deserialize(std::string_view data, std::vector<T> t_)
+        {
+            return deserialize(data, std::move(t_), 0);
+        }
+
         /**
          * @brief Get the postions of the compressed measurement
          * 
@@ -177,6 +445,41 @@ namespace measCompress
          */
         const std::vector<std::size_t> &GetPos() const noexcept { return position; }
 
+        /**
+         * @brief Get the number of points checked by the last fit
+         * 
+         * Sum of the segment lengths of all checks, a measure of the fitting
+         * effort (e.g. to compare the parallel and the sequential search).
+         * 
+         * @return std::size_t 
+         */
+        std::size_t GetCheckedPoints() const noexcept { return checked_points; }
+
+        /**
+         * @brief Get the number of points on the critical path of the last fit
+         * 
+         * Sum of the segment lengths of the longest check of every sequential
+         * step (checks in parallel count once), a measure of the latency.
+         * Equal to GetCheckedPoints for the sequential search.
+         * 
+         * @return std::size_t 
+         */
+        std::size_t GetCriticalPoints() const noexcept { return critical_points; }
+
+        /**
+         * @brief Get the number of threads of the fit (see SetParallel)
+         * 
+         * @return std::size_t 
+         */
+        std::size_t GetThreads() const noexcept { return n_threads; }
+
+        /**
+         * @brief Get the minimal intervall size for the parallel search (see SetParallel)
+         * 
+         * @return std::size_t 
+         */
+        std::size_t GetParallelMinSize() const noexcept { return parallel_min_size; }
+
         /**
          * @brief Get the x-vector (time) of the original measurement
          * 
@@ -192,26 +495,137 @@ namespace measCompress
         std::vector<T> GetTimeFit() const { return TransformNoFit(t); }
 
     private:
-        std::size_t binary_search(const std::vector<Dependency<T>> &deps,
+        // first: values at the first point (nullptr: fitted as well)
+        std::vector<std::vector<T>> transform_continuous(const std::vector<const std::vector<T> *> &ys,
+                                                         const std::vector<T> *first,
+                                                         const Progress &progress) const
+        {
+            for (const auto *y : ys)
+            {
+                if (y->size() != t.size())
+                    throw InvalidSize();
+            }
+            if (position.size() < 2)
+                throw InvalidSize();
+
+            // hat function of breakpoint k at the point j in segment k:
+            // phi_k = 1 - s_j, phi_{k+1} = s_j, s_j = (t_j - t_k) / (t_{k+1} - t_k)
+            // every point belongs to exactly one segment (the last point to
+            // the last segment)
+            const auto n_pos = position.size();
+            auto for_each_point = [this, n_pos](auto &&func)
+            {
+                for (std::size_t k = 0; k + 1 < n_pos; ++k)
+                {
+                    const auto i0 = position[k];
+                    const auto i1 = position[k + 1];
+                    const auto end = k + 2 == n_pos ? i1 + 1 : i1;
+                    const auto dt = t[i1] - t[i0];
+                    for (std::size_t j = i0; j < end; ++j)
+                    {
+                        const auto s = dt == T(0) ? T(0) : (t[j] - t[i0]) / dt;
+                        func(k, j, s);
+                    }
+                }
+            };
+
+            const auto total = t.size() * (ys.size() + 1);
+            auto reporter = progress.Start();
+            if (progress.IsCancelled())
+                throw Cancelled();
+
+            std::vector<T> diag(n_pos, T(0));
+            std::vector<T> off(n_pos - 1, T(0));
+            for_each_point([&](std::size_t k, std::size_t, T s)
+                           {
+                               diag[k] += (1 - s) * (1 - s);
+                               off[k] += (1 - s) * s;
+                               diag[k + 1] += s * s;
+                           });
+            // a given first value is no unknown, its column of the matrix
+            // moves to the right hand side
+            const std::size_t k0 = first ? 1 : 0;
+            const std::vector<T> off_(off.begin() + k0, off.end());
+            const Tridiagonal<T> system(off_, std::vector<T>(diag.begin() + k0, diag.end()), off_);
+            reporter.Update(t.size(), total);
+
+            std::vector<std::vector<T>> result(ys.size());
+            for (std::size_t i = 0; i < ys.size(); ++i)
+            {
+                if (progress.IsCancelled())
+                    throw Cancelled();
+
+                const auto &y = *ys[i];
+                auto &rhs = result[i];
+                rhs.assign(n_pos, T(0));
+                for_each_point([&](std::size_t k, std::size_t j, T s)
+                               {
+                                   rhs[k] += (1 - s) * y[j];
+                                   rhs[k + 1] += s * y[j];
+                               });
+                if (first)
+                {
+                    rhs[1] -= off[0] * (*first)[i];
+                    rhs[0] = (*first)[i];
+                }
+                system.Solve(std::span<T>(rhs).subspan(k0));
+                reporter.Update((i + 2) * t.size(), total);
+            }
+            return result;
+        }
+
+        template <typename Dep>
+        std::size_t binary_search(const std::vector<Dep> &deps,
                                   std::size_t i0, std::size_t last_step)
         {
-            auto check = [this, &deps, i0](std::size_t i1)
+            std::atomic<std::size_t> checked = 0;
+            auto check = [this, &deps, i0, &checked](std::size_t i1)
             {
+                checked.fetch_add(i1 - i0, std::memory_order_relaxed);
                 for (const auto &dep : deps)
                     if (!dep.Check(t, i0, i1))
                         return false;
                 return true;
             };
-            // consider: check(a) is always true
 
             std::size_t a = i0 + 2;
             std::size_t b = std::min(a + last_step, t.size());
             if (a >= t.size())
                 return t.size();
 
-            // go with big steps forward until dependency are false
-            while (check(b))
+            std::size_t critical = 0;
+            const auto result = search(check, i0, a, b, critical);
+            checked_points += checked.load(std::memory_order_relaxed);
+            critical_points += critical;
+            return result;
+        }
+
+        // galloping and binary search for the last end point with check == true
+        // in [a, t.size()], consider: check(a) is always true, 'critical' is
+        // increased by the longest check of every sequential step
+        template <typename Check>
+        std::size_t search(const Check &check, std::size_t i0,
+                           std::size_t a, std::size_t b,
+                           std::size_t &critical) const
+        {
+            auto check_seq = [&](std::size_t i1)
+            {
+                critical += i1 - i0;
+                return check(i1);
+            };
+            auto check_par = [&](const std::vector<std::size_t> &candidates)
+            {
+                critical += candidates.back() - i0;
+                return first_fail(check, candidates);
+            };
+
+            // go with big steps forward until dependency are false (always
+            // sequential: speculative steps in parallel are awaited together,
+            // so a step would cost the time of the farthest one)
+            while (true)
             {
+                if (!check_seq(b))
+                    break;
                 if (b == t.size())
                     return b;
                 a = b;
@@ -223,8 +637,24 @@ namespace measCompress
             // binary search
             while (a + 1 < b)
             {
+                if (use_threads(b - i0) && b - a > n_threads)
+                {
+                    // split [a, b] in n_threads + 1 parts and check the
+                    // inner points in parallel
+                    std::vector<std::size_t> probes;
+                    for (std::size_t j = 1; j <= n_threads; ++j)
+                        probes.push_back(a + (b - a) * j / (n_threads + 1));
+
+                    const auto k = check_par(probes);
+                    if (k > 0)
+                        a = probes[k - 1];
+                    if (k < probes.size())
+                        b = probes[k];
+                    continue;
+                }
+
                 auto m = (a + b) / 2;
-                if (check(m))
+                if (check_seq(m))
                     a = m;
                 else
                     b = m;
@@ -232,9 +662,132 @@ namespace measCompress
             return a;
         }
 
+        static bool valid_position(const std::vector<std::size_t> &position_,
+                                   std::size_t n) noexcept
+        {
+            if (position_.size() < 2 || position_.front() != 0 ||
+                position_.back() + 1 != n)
+                return false;
+            for (std::size_t i = 1; i < position_.size(); ++i)
+                if (position_[i - 1] >= position_[i])
+                    return false;
+            return true;
+        }
+
+        // store t0 and dt if t is exactly reproduced by t_i = t0 + i * dt
+        void detect_grid()
+        {
+            grid.reset();
+            const auto dt = t[1] - t[0];
+            for (std::size_t i = 0; i < t.size(); ++i)
+                if (t[i] != t[0] + T(i) * dt)
+                    return;
+            grid = {t[0], dt};
+        }
+
+        static Compressor deserialize(std::string_view data,
+                                      std::optional<std::vector<T>> t_,
+                                      std::size_t max_grid_size)
+        {
+            auto read = [&data](void *ptr, std::size_t size)
+            {
+                if (data.size() < size)
+                    throw InvalidFormat();
+                std::memcpy(ptr, data.data(), size);
+                data.remove_prefix(size);
+            };
+            std::uint32_t header[4];
+            std::uint64_t sizes[2];
+            read(header, sizeof(header));
+            read(sizes, sizeof(sizes));
+            const auto flags = header[3];
+            if (header[0] != magic || header[1] != version ||
+                header[2] != sizeof(T) || flags > flag_grid ||
+                sizes[1] > data.size() / sizeof(std::uint64_t))
+                throw InvalidFormat();
+
+            // not fitted
+            if (sizes[1] == 0)
+            {
+                if (sizes[0] != 0 || flags != 0 || !data.empty())
+                    throw InvalidFormat();
+                if (t_ && !t_->empty())
+                    throw DifferentSize();
+                return Compressor();
+            }
+
+            std::vector<std::size_t> position_(sizes[1]);
+            for (auto &pos : position_)
+            {
+                std::uint64_t value;
+                read(&value, sizeof(value));
+                pos = static_cast<std::size_t>(value);
+            }
+            // before any allocation with the stored size (a grid is also
+            // limited by max_grid_size, its positions can be forged as well)
+            if (!valid_position(position_, sizes[0]))
+                throw InvalidFormat();
+
+            if (t_)
+            {
+                if (t_->size() != sizes[0])
+                    throw DifferentSize();
+                return Compressor(std::move(*t_), std::move(position_));
+            }
+            if (flags == flag_grid)
+            {
+                if (sizes[0] > max_grid_size)
+                    throw InvalidFormat();
+                T t0, dt;
+                read(&t0, sizeof(T));
+                read(&dt, sizeof(T));
+                return FromGrid(t0, dt, sizes[0], std::move(position_));
+            }
+            if (flags != flag_time || data.size() % sizeof(T) != 0 ||
+                data.size() / sizeof(T) != sizes[0])
+                throw InvalidFormat();
+            std::vector<T> time(sizes[0]);
+            read(time.data(), time.size() * sizeof(T));
+            return Compressor(std::move(time), std::move(position_));
+        }
+
+        bool use_threads(std::size_t size) const noexcept
+        {
+            return n_threads > 1 && size >= parallel_min_size;
+        }
+
+        // index of the first candidate with check(candidate) == false
+        // (candidates.size() if all are true), candidates are checked in parallel
+        template <typename Check>
+        static std::size_t first_fail(const Check &check,
+                                      const std::vector<std::size_t> &candidates)
+        {
+            std::vector<std::future<bool>> futures;
+            futures.reserve(candidates.size());
+            for (std::size_t j = 1; j < candidates.size(); ++j)
+                futures.push_back(std::async(std::launch::async, check, candidates[j]));
+
+            if (!check(candidates[0]))
+                return 0;
+            for (std::size_t j = 1; j < candidates.size(); ++j)
+                if (!futures[j - 1].get())
+                    return j;
+            return candidates.size();
+        }
+
     private:
+        static constexpr std::uint32_t magic = 0x504d434d; // "MCMP"
+        static constexpr std::uint32_t version = 1;
+        static constexpr std::uint32_t flag_time = 1;
+        static constexpr std::uint32_t flag_grid = 2;
+
         std::vector<std::size_t> position;
         std::vector<T> t;
+        std::optional<std::pair<T, T>> grid;
+        std::size_t n_threads = 1;
+        std::size_t parallel_min_size = std::size_t(1) << 16;
+        std::size_t checked_points = 0;
+        std::size_t critical_points = 0;
     };
 
 } // namespace measCompress
@@ -2,6 +2,12 @@
 #define MEASCOMPRESS_DEPENDENCY_HPP
 
 #include "./line.hpp"
+#include "./error_norm.hpp"
+
+#include <vector>
+#include <memory>
+#include <concepts>
+#include <type_traits>
 
 #include <string>
 #include <exception>
@@ -11,9 +17,13 @@ namespace measCompress
     /**
      * @brief Describs a dependency for a single timeseries of a measurement
      * 
+     * The error norm is a compile time policy (see error_norm.hpp), so the
+     * check of an intervall contains no runtime dispatch.
+     * 
      * @tparam T double (default)
+     * @tparam Norm error norm, AbsMaxError<T> (default)
      */
-    template <typename T = double>
+    template <typename T = double, typename Norm = AbsMaxError<T>>
     class Dependency
     {
     public:
@@ -83,14 +93,24 @@ namespace measCompress
          * @param tol allowed approximation tolerance/error
          */
         Dependency(std::vector<T> y_, T tol_)
+            requires std::is_constructible_v<Norm, T>
+            : Dependency(std::move(y_), Norm(std::move(tol_))) {}
+
+        /**
+         * @brief Construct a new Dependency object
+         * 
+         * @param y data of a timeseries
+         * @param norm error norm with the allowed approximation tolerance/error
+         */
+        Dependency(std::vector<T> y_, Norm norm_)
             : y(std::move(y_)),
-              tol(std::move(tol_))
+              norm(std::move(norm_))
         {
             if (y.size() < 2)
             {
                 throw InvalidSize();
             }
-            if (tol < T(0))
+            if (!norm.IsValid())
             {
                 throw InvalidTolerance();
             }
@@ -126,8 +146,7 @@ namespace measCompress
             auto y_ = std::span<const T>(y.begin() + i0, y.begin() + i1);
 
             auto line = Line<T>::Fit(t_, y_);
-            auto error = line.GetMaxError(t_, y_);
-            return error < tol;
+            return norm.Check(line, t_, y_);
         }
 
         /**
@@ -139,7 +158,81 @@ namespace measCompress
 
     private:
         std::vector<T> y;
-        T tol;
+        Norm norm;
+    };
+
+    /**
+     * @brief Dependency with any error norm
+     * 
+     * Allows to combine dependencies with different error norms (predefined
+     * or user defined) in a single Compressor::Fit. The dependency is
+     * dispatched once per check (one indirect call) and not per point.
+     * Copies share the same dependency.
+     * 
+     * @tparam T double (default)
+     */
+    template <typename T = double>
+    class AnyDependency
+    {
+    public:
+        /**
+         * @brief Construct a new AnyDependency object
+         * 
+         * @param dep dependency, e.g. Dependency<T, Norm> with any error norm
+         */
+        template <typename Dep>
+            requires(!std::is_same_v<std::remove_cvref_t<Dep>, AnyDependency> &&
+                     requires(const Dep &d, const std::vector<T> &t) {
+                         { d.Check(t, std::size_t(0), std::size_t(0)) } -> std::convertible_to<bool>;
+                         { d.GetSize() } -> std::convertible_to<std::size_t>;
+                     })
+        AnyDependency(Dep dep)
+            : dep(std::make_shared<const Model<Dep>>(std::move(dep))) {}
+
+        /**
+         * @brief Check if a give intervall can approximate with a line
+         * 
+         * @see Dependency::Check
+         */
+        bool Check(const std::vector<T> &t,
+                   std::size_t i0,
+                   std::size_t i1) const
+        {
+            return dep->Check(t, i0, i1);
+        }
+
+        /**
+         * @brief Get the Size of the timeseries
+         * 
+         * @return std::size_t 
+         */
+        std::size_t GetSize() const noexcept { return dep->GetSize(); }
+
+    private:
+        class Concept
+        {
+        public:
+            virtual ~Concept() = default;
+            virtual bool Check(const std::vector<T> &t, std::size_t i0, std::size_t i1) const = 0;
+            virtual std::size_t GetSize() const noexcept = 0;
+        };
+
+        template <typename Dep>
+        class Model final : public Concept
+        {
+        public:
+            explicit Model(Dep dep) : dep(std::move(dep)) {}
+            bool Check(const std::vector<T> &t, std::size_t i0, std::size_t i1) const override
+            {
+                return dep.Check(t, i0, i1);
+            }
+            std::size_t GetSize() const noexcept override { return dep.GetSize(); }
+
+        private:
+            Dep dep;
+        };
+
+        std::shared_ptr<const Concept> dep;
     };
 
 } // namespace measCompress
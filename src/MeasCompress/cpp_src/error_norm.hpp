@@ -0,0 +1,245 @@
+#ifndef MEASCOMPRESS_ERROR_NORM_HPP
+#define MEASCOMPRESS_ERROR_NORM_HPP
+
+#include "./line.hpp"
+
+#include <span>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <execution>
+#include <limits>
+
+namespace measCompress
+{
+    /**
+     * @brief Absolute error in the infinity norm
+     *
+     * max_i |y_i - line(t_i)| < tol
+     *
+     * @tparam T double (default)
+     */
+    template <typename T = double>
+    class AbsMaxError
+    {
+    public:
+        /**
+         * @brief Construct a new AbsMaxError object
+         *
+         * @param tol allowed absolute error
+         */
+        explicit AbsMaxError(T tol) : tol(std::move(tol)) {}
+
+        /**
+         * @brief Check if the tolerance is valid (>= 0)
+         */
+        bool IsValid() const noexcept { return tol >= T(0); }
+
+        /**
+         * @brief Check if the line approximates the points
+         *
+         * @param line fitted line
+         * @param t x coordinates of the points
+         * @param y y coordinates of the points
+         * @return true, if the error is within the tolerance
+         * @return false, else
+         */
+        bool Check(const Line<T> &line,
+                   std::span<const T> t,
+                   std::span<const T> y) const
+        {
+            return line.GetMaxError(t, y) < tol;
+        }
+
+    private:
+        T tol;
+    };
+
+    /**
+     * @brief Relative error in the infinity norm
+     *
+     * |y_i - line(t_i)| < tol * |y_i| or y_i == line(t_i) for all points
+     *
+     * (a point with y_i = 0 must be fitted exactly, see AbsRelMaxError)
+     *
+     * @tparam T double (default)
+     */
+    template <typename T = double>
+    class RelMaxError
+    {
+    private:
+        static constexpr auto execution_policy = std::execution::seq;
+
+    public:
+        /**
+         * @brief Construct a new RelMaxError object
+         *
+         * @param tol allowed relative error
+         */
+        explicit RelMaxError(T tol) : tol(std::move(tol)) {}
+
+        /**
+         * @brief Check if the tolerance is valid (>= 0)
+         */
+        bool IsValid() const noexcept { return tol >= T(0); }
+
+        /**
+         * @brief Check if the line approximates the points
+         *
+         * @param line fitted line
+         * @param t x coordinates of the points
+         * @param y y coordinates of the points
+         * @return true, if the error is within the tolerance
+         * @return false, else
+         */
+        bool Check(const Line<T> &line,
+                   std::span<const T> t,
+                   std::span<const T> y) const
+        {
+            // max_i (|e_i| - tol * |y_i|), an exact point is always within
+            auto excess = std::transform_reduce(
+                execution_policy,
+                t.begin(), t.end(),
+                y.begin(),
+                -std::numeric_limits<T>::infinity(),
+                [](const T &ex0, const T &exi) {
+                    return std::max(ex0, exi);
+                },
+                [this, &line](const T &ti, const T &yi) {
+                    const auto ei = std::abs(yi - line.GetY(ti));
+                    return ei == T(0) ? -std::numeric_limits<T>::infinity()
+                                      : ei - tol * std::abs(yi);
+                });
+            return excess < T(0);
+        }
+
+    private:
+        T tol;
+    };
+
+    /**
+     * @brief Absolute error in the root mean square norm
+     *
+     * sqrt(sum_i (y_i - line(t_i))^2 / n) < tol
+     *
+     * @tparam T double (default)
+     */
+    template <typename T = double>
+    class RmsError
+    {
+    private:
+        static constexpr auto execution_policy = std::execution::seq;
+
+    public:
+        /**
+         * @brief Construct a new RmsError object
+         *
+         * @param tol allowed root mean square error
+         */
+        explicit RmsError(T tol) : tol(std::move(tol)) {}
+
+        /**
+         * @brief Check if the tolerance is valid (>= 0)
+         */
+        bool IsValid() const noexcept { return tol >= T(0); }
+
+        /**
+         * @brief Check if the line approximates the points
+         *
+         * @param line fitted line
+         * @param t x coordinates of the points
+         * @param y y coordinates of the points
+         * @return true, if the error is within the tolerance
+         * @return false, else
+         */
+        bool Check(const Line<T> &line,
+                   std::span<const T> t,
+                   std::span<const T> y) const
+        {
+            auto sum = std::transform_reduce(
+                execution_policy,
+                t.begin(), t.end(),
+                y.begin(),
+                T(0),
+                std::plus<T>(),
+                [&line](const T &ti, const T &yi) {
+                    const auto e = yi - line.GetY(ti);
+                    return e * e;
+                });
+            return std::sqrt(sum / y.size()) < tol;
+        }
+
+    private:
+        T tol;
+    };
+
+    /**
+     * @brief Combined absolute and relative error in the infinity norm
+     *
+     * |y_i - line(t_i)| < atol + rtol * |y_i| or y_i == line(t_i) for all points
+     *
+     * (same as AbsMaxError for rtol = 0 and atol > 0, same as RelMaxError
+     * for atol = 0)
+     *
+     * @tparam T double (default)
+     */
+    template <typename T = double>
+    class AbsRelMaxError
+    {
+    private:
+        static constexpr auto execution_policy = std::execution::seq;
+
+    public:
+        /**
+         * @brief Construct a new AbsRelMaxError object
+         *
+         * @param atol allowed absolute error
+         * @param rtol allowed relative error
+         */
+        AbsRelMaxError(T atol, T rtol)
+            : atol(std::move(atol)),
+              rtol(std::move(rtol)) {}
+
+        /**
+         * @brief Check if the tolerances are valid (>= 0)
+         */
+        bool IsValid() const noexcept { return atol >= T(0) && rtol >= T(0); }
+
+        /**
+         * @brief Check if the line approximates the points
+         *
+         * @param line fitted line
+         * @param t x coordinates of the points
+         * @param y y coordinates of the points
+         * @return true, if the error is within the tolerance
+         * @return false, else
+         */
+        bool Check(const Line<T> &line,
+                   std::span<const T> t,
+                   std::span<const T> y) const
+        {
+            // max_i (|e_i| - rtol * |y_i|), an exact point is always within
+            auto excess = std::transform_reduce(
+                execution_policy,
+                t.begin(), t.end(),
+                y.begin(),
+                -std::numeric_limits<T>::infinity(),
+                [](const T &ex0, const T &exi) {
+                    return std::max(ex0, exi);
+                },
+                [this, &line](const T &ti, const T &yi) {
+                    const auto ei = std::abs(yi - line.GetY(ti));
+                    return ei == T(0) ? -std::numeric_limits<T>::infinity()
+                                      : ei - rtol * std::abs(yi);
+                });
+            return excess < atol;
+        }
+
+    private:
+        T atol;
+        T rtol;
+    };
+
+} // namespace measCompress
+
+#endif
@@ -88,24 +88,26 @@ namespace measCompress
             const auto t0 = t[0];
 
             // sum (dt_i)
-            auto dt_sum = std::reduce(execution_policy,
-                                      t.begin(), t.end(),
-                                      T(0),
-                                      [&t0](const T &re, const T &ti) {
-                                          return (re + (ti - t0));
-                                      });
+            auto dt_sum = std::transform_reduce(execution_policy,
+                                                t.begin(), t.end(),
+                                                T(0),
+                                                std::plus<T>(),
+                                                [&t0](const T &ti) {
+                                                    return (ti - t0);
+                                                });
             // sum (y_i)
             auto y_sum = std::reduce(execution_policy,
                                      y.begin(), y.end(),
                                      T(0),
                                      std::plus<T>());
             // sum (dt_i * dt_i)
-            auto dtdt_sum = std::reduce(execution_policy,
-                                        t.begin(), t.end(),
-                                        T(0),
-                                        [&t0](const T &re, const T &ti) {
-                                            return (re + (ti - t0) * (ti - t0));
-                                        });
+            auto dtdt_sum = std::transform_reduce(execution_policy,
+                                                  t.begin(), t.end(),
+                                                  T(0),
+                                                  std::plus<T>(),
+                                                  [&t0](const T &ti) {
+                                                      return ((ti - t0) * (ti - t0));
+                                                  });
             // sum (dt_i * y_i)
             auto dty_sum = std::transform_reduce(execution_policy,
                                                  t.begin(), t.end(),
@@ -140,7 +142,7 @@ namespace measCompress
          * @param y y coordinates of the points
          * @return T max error (infinity norm)
          */
-        T GetMaxError(std::span<const T> t, std::span<const T> y)
+        T GetMaxError(std::span<const T> t, std::span<const T> y) const
         {
             if (t.size() != y.size())
             {
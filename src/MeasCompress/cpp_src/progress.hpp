@@ -0,0 +1,134 @@
+#ifndef MEASCOMPRESS_PROGRESS_HPP
+#define MEASCOMPRESS_PROGRESS_HPP
+
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <optional>
+
+namespace measCompress
+{
+    /**
+     * @brief Token for a cooperative cancellation
+     *
+     * Copies of a token share the same state, so a long-running computation
+     * can be cancelled from another thread.
+     */
+    class CancelToken
+    {
+    public:
+        /**
+         * @brief Construct a new CancelToken object (not cancelled)
+         */
+        CancelToken() : cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+        /**
+         * @brief Request the cancellation
+         */
+        void Cancel() noexcept { cancelled->store(true, std::memory_order_relaxed); }
+
+        /**
+         * @brief Check if the cancellation is requested
+         */
+        bool IsCancelled() const noexcept { return cancelled->load(std::memory_order_relaxed); }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+
+    /**
+     * @brief Progress reporting and cancellation of a long-running computation
+     *
+     * The computation calls Start once and Update of the returned Reporter
+     * after every processed block of samples, the callback is invoked at most
+     * every 'step' samples (and at the end). The reporting state belongs to
+     * the Reporter, so an object can be used for several computations (also
+     * concurrently, if the callback is thread safe).
+     */
+    class Progress
+    {
+    public:
+        /**
+         * @brief Callback with the number of processed and total samples
+         */
+        using Callback = std::function<void(std::size_t, std::size_t)>;
+
+        /**
+         * @brief Reporting state of a single computation (see Start)
+         */
+        class Reporter
+        {
+        public:
+            /**
+             * @brief Report the number of processed samples
+             *
+             * @param done number of processed samples
+             * @param total total number of samples
+             */
+            void Update(std::size_t done, std::size_t total)
+            {
+                if (progress.callback && (done >= next || done == total))
+                {
+                    next = done + progress.step;
+                    progress.callback(done, total);
+                }
+            }
+
+        private:
+            friend class Progress;
+            explicit Reporter(const Progress &progress) noexcept : progress(progress) {}
+
+            const Progress &progress;
+            std::size_t next = 0;
+        };
+
+    public:
+        /**
+         * @brief Construct a new Progress object without reporting/cancellation
+         */
+        Progress() = default;
+
+        /**
+         * @brief Construct a new Progress object
+         *
+         * @param callback invoked with the number of processed and total samples
+         * @param step minimal number of samples between two callbacks
+         * @param token cancellation token
+         */
+        Progress(Callback callback, std::size_t step = 65536,
+                 std::optional<CancelToken> token = std::nullopt)
+            : callback(std::move(callback)),
+              step(step),
+              token(std::move(token)) {}
+
+        /**
+         * @brief Construct a new Progress object with cancellation only
+         *
+         * @param token cancellation token
+         */
+        Progress(CancelToken token) : token(std::move(token)) {}
+
+        /**
+         * @brief Start a new computation (no samples processed)
+         *
+         * @return Reporter (must not outlive this object)
+         */
+        Reporter Start() const noexcept { return Reporter(*this); }
+
+        /**
+         * @brief Check if the cancellation is requested
+         */
+        bool IsCancelled() const noexcept
+        {
+            return token && token->IsCancelled();
+        }
+
+    private:
+        Callback callback;
+        std::size_t step = 0;
+        std::optional<CancelToken> token;
+    };
+
+} // namespace measCompress
+
+#endif
@@ -0,0 +1,297 @@
+#ifndef MEASCOMPRESS_READER_HPP
+#define MEASCOMPRESS_READER_HPP
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <istream>
+#include <charconv>
+#include <exception>
+
+namespace measCompress
+{
+    /**
+     * @brief Reads a measurement table from a CSV stream chunk by chunk
+     *
+     * The first line of the stream contains the column names, every further
+     * line contains one measurement point. The values are parsed with
+     * std::from_chars (locale independent and without allocations).
+     *
+     * @tparam T double (default)
+     */
+    template <typename T = double>
+    class CsvReader
+    {
+    public:
+        /**
+        * @brief Base exceptions class
+        */
+        class Exception : public std::exception
+        {
+        public:
+            Exception(std::string data) : data(std::move(data)) {}
+            const char *what() const noexcept override
+            {
+                return data.c_str();
+            }
+
+        protected:
+            std::string data;
+        };
+
+        /**
+         * @brief Missing header exception
+         *
+         * e.g. the stream is empty
+         */
+        class MissingHeader : public Exception
+        {
+        public:
+            MissingHeader() : Exception("missing header line") {}
+        };
+
+        /**
+         * @brief Parse error exception
+         *
+         * e.g. a value is not a number or the number of values in a line is
+         * different to the number of columns
+         */
+        class ParseError : public Exception
+        {
+        public:
+            ParseError(std::size_t line)
+                : Exception("parse error in line " + std::to_string(line)) {}
+        };
+
+    public:
+        /**
+         * @brief Construct a new CsvReader object and read the header line
+         *
+         * @param in input stream
+         * @param delimiter column separator
+         */
+        CsvReader(std::istream &in, char delimiter = ',')
+            : in(in),
+              delimiter(delimiter)
+        {
+            if (!std::getline(in, line))
+            {
+                throw MissingHeader();
+            }
+            ++line_number;
+            strip_cr();
+
+            std::string_view rest(line);
+            while (true)
+            {
+                const auto pos = rest.find(delimiter);
+                names.emplace_back(trim(rest.substr(0, pos)));
+                if (pos == std::string_view::npos)
+                    break;
+                rest.remove_prefix(pos + 1);
+            }
+        }
+
+        /**
+         * @brief Read the next chunk of the table
+         *
+         * The values will be appended to the columns. Empty lines are skipped.
+         *
+         * @param columns column wise storage (resized to the number of columns)
+         * @param max_rows maximum number of rows to read
+         * @return std::size_t number of rows read (0 at the end of the stream)
+         */
+        std::size_t Read(std::vector<std::vector<T>> &columns,
+                         std::size_t max_rows)
+        {
+            columns.resize(names.size());
+
+            std::size_t rows = 0;
+            while (rows < max_rows && std::getline(in, line))
+            {
+                ++line_number;
+                strip_cr();
+                if (line.empty())
+                    continue;
+
+                const char *first = line.data();
+                const char *last = line.data() + line.size();
+                for (std::size_t i = 0; i < columns.size(); ++i)
+                {
+                    while (first != last && *first == ' ')
+                        ++first;
+                    if (first != last && *first == '+')
+                        ++first;
+
+                    T value;
+                    const auto [ptr, ec] = std::from_chars(first, last, value);
+                    if (ec != std::errc())
+                        throw ParseError(line_number);
+                    first = ptr;
+
+                    while (first != last && *first == ' ')
+                        ++first;
+                    const bool is_last = i + 1 == columns.size();
+                    if (is_last ? first != last : (first == last || *first != delimiter))
+                        throw ParseError(line_number);
+                    if (!is_last)
+                        ++first;
+
+                    columns[i].push_back(value);
+                }
+                ++rows;
+            }
+            return rows;
+        }
+
+        /**
+         * @brief Get the column names of the table
+         *
+         * @return const std::vector<std::string>&
+         */
+        const std::vector<std::string> &GetNames() const noexcept { return names; }
+
+    private:
+        void strip_cr()
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+        }
+
+        static std::string_view trim(std::string_view str)
+        {
+            while (!str.empty() && str.front() == ' ')
+                str.remove_prefix(1);
+            while (!str.empty() && str.back() == ' ')
+                str.remove_suffix(1);
+            return str;
+        }
+
+    private:
+        std::istream &in;
+        char delimiter;
+        std::vector<std::string> names;
+        std::string line;
+        std::size_t line_number = 0;
+    };
+
+    /**
+     * @brief Reads a measurement table from a raw binary stream chunk by chunk
+     *
+     * The stream contains the values row by row in the native binary
+     * representation of T without any header.
+     *
+     * @tparam T double (default)
+     */
+    template <typename T = double>
+    class BinaryReader
+    {
+    public:
+        /**
+        * @brief Base exceptions class
+        */
+        class Exception : public std::exception
+        {
+        public:
+            Exception(std::string data) : data(std::move(data)) {}
+            const char *what() const noexcept override
+            {
+                return data.c_str();
+            }
+
+        protected:
+            std::string data;
+        };
+
+        /**
+         * @brief Invalid sizes exception
+         *
+         * e.g. number of columns is zero
+         */
+        class InvalidSize : public Exception
+        {
+        public:
+            InvalidSize() : Exception("at least one column is required") {}
+        };
+
+        /**
+         * @brief Truncated stream exception
+         *
+         * e.g. the size of the stream is not a multiple of the row size
+         */
+        class Truncated : public Exception
+        {
+        public:
+            Truncated() : Exception("stream ends within a row") {}
+        };
+
+    public:
+        /**
+         * @brief Construct a new BinaryReader object
+         *
+         * The columns are named "0", "1", ...
+         *
+         * @param in input stream (opened in binary mode)
+         * @param n_columns number of values per row
+         */
+        BinaryReader(std::istream &in, std::size_t n_columns)
+            : in(in)
+        {
+            if (n_columns == 0)
+            {
+                throw InvalidSize();
+            }
+            for (std::size_t i = 0; i < n_columns; ++i)
+                names.push_back(std::to_string(i));
+        }
+
+        /**
+         * @brief Read the next chunk of the table
+         *
+         * The values will be appended to the columns.
+         *
+         * @param columns column wise storage (resized to the number of columns)
+         * @param max_rows maximum number of rows to read
+         * @return std::size_t number of rows read (0 at the end of the stream)
+         */
+        std::size_t Read(std::vector<std::vector<T>> &columns,
+                         std::size_t max_rows)
+        {
+            const auto n_columns = names.size();
+            columns.resize(n_columns);
+
+            buffer.resize(max_rows * n_columns);
+            in.read(reinterpret_cast<char *>(buffer.data()),
+                    static_cast<std::streamsize>(buffer.size() * sizeof(T)));
+            const auto bytes = static_cast<std::size_t>(in.gcount());
+            if (bytes % (n_columns * sizeof(T)) != 0)
+                throw Truncated();
+
+            const auto rows = bytes / (n_columns * sizeof(T));
+            for (std::size_t i = 0; i < n_columns; ++i)
+            {
+                auto &column = columns[i];
+                const auto offset = column.size();
+                column.resize(offset + rows);
+                for (std::size_t j = 0; j < rows; ++j)
+                    column[offset + j] = buffer[j * n_columns + i];
+            }
+            return rows;
+        }
+
+        /**
+         * @brief Get the column names of the table
+         *
+         * @return const std::vector<std::string>&
+         */
+        const std::vector<std::string> &GetNames() const noexcept { return names; }
+
+    private:
+        std::istream &in;
+        std::vector<std::string> names;
+        std::vector<T> buffer;
+    };
+
+} // namespace measCompress
+
+#endif
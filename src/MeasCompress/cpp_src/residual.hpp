@@ -0,0 +1,468 @@
+#ifndef MEASCOMPRESS_RESIDUAL_HPP
+#define MEASCOMPRESS_RESIDUAL_HPP
+
+#include <vector>
+#include <bit>
+#include <cmath>
+#include <future>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#include <string>
+#include <exception>
+
+#include "./compressor.hpp"
+
+namespace measCompress
+{
+    /**
+     * @brief Residuals between a measurement and its compressed version
+     *
+     * Together with the compressed measurement (Compressor and the
+     * transformed values y_fit), the residuals restore the original
+     * timeseries: lossless (max_error = 0) or with a bounded error.
+     *
+     * The prediction of a point is the linear interpolation of y_fit. The
+     * residual is stored as
+     *  - lossless: difference of the binary representations of the value
+     *    and the prediction (mapped to integers in the order of the values)
+     *  - bounded error: round((y - prediction) / (2 * max_error)), corrected
+     *    by +-1 if the decoded value would exceed max_error. A segment with
+     *    a value which can not be quantized within max_error (e.g. not
+     *    finite, or max_error close to the resolution of the values) is
+     *    stored lossless.
+     * zigzag encoded and bit-packed with a fixed width per segment. Every
+     * segment starts at a word boundary, so the segments are decoded
+     * independently (in parallel).
+     *
+     * @tparam T double (default)
+     */
+    template <typename T = double>
+    class Residual
+    {
+        static_assert(std::is_floating_point_v<T> && (sizeof(T) == 4 || sizeof(T) == 8),
+                      "T must be float or double");
+
+    private:
+        using Bits = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+        using Word = std::uint64_t;
+        static constexpr std::size_t word_bits = 64;
+
+    public:
+        /**
+        * @brief Base exceptions class
+        */
+        class Exception : public std::exception
+        {
+        public:
+            Exception(std::string data) : data(std::move(data)) {}
+            const char *what() const noexcept override
+            {
+                return data.c_str();
+            }
+
+        protected:
+            std::string data;
+        };
+
+        /**
+         * @brief Invalid sizes exception
+         *
+         * e.g. the size of y_fit is different to the number of compressed
+         * points
+         */
+        class InvalidSize : public Exception
+        {
+        public:
+            InvalidSize() : Exception("at least one vector has an invalid dimension") {}
+        };
+
+        /**
+         * @brief Invalid tolerance exception
+         *
+         * e.g. max_error < 0
+         */
+        class InvalidTolerance : public Exception
+        {
+        public:
+            InvalidTolerance() : Exception("max_error must be >= 0") {}
+        };
+
+        /**
+         * @brief Invalid format exception
+         *
+         * e.g. serialized data is truncated or from a different type T
+         */
+        class InvalidFormat : public Exception
+        {
+        public:
+            InvalidFormat() : Exception("invalid serialized residual") {}
+        };
+
+    public:
+        /**
+         * @brief Encode the residuals of a timeseries
+         *
+         * @param comp fitted compressor
+         * @param y timeseries of the original measurement
+         * @param y_fit compressed version of y (e.g. Compressor::Transform)
+         * @param max_error allowed error of the decoded timeseries (0: lossless)
+         * @param n_threads number of threads
+         * @return Residual
+         */
+        static Residual Encode(const Compressor<T> &comp,
+                               const std::vector<T> &y,
+                               const std::vector<T> &y_fit,
+                               T max_error = T(0),
+                               std::size_t n_threads = 1)
+        {
+            if (!(max_error >= T(0)))
+                throw InvalidTolerance();
+            check_size(comp, y_fit);
+            if (y.size() != comp.GetTimeOrigin().size())
+                throw InvalidSize();
+
+            Residual result;
+            result.step = 2 * max_error;
+            const auto n_seg = comp.GetPos().size() - 1;
+
+            // 1. bit width (and mode) of every segment
+            result.width.resize(n_seg);
+            parallel_for(n_threads, n_seg, [&](std::size_t k)
+                         {
+                             Word max = 0;
+                             bool lossless = result.step == T(0);
+                             if (!lossless)
+                             {
+                                 result.for_each_point(comp, y_fit, k, [&](std::size_t j, T p)
+                                                       {
+                                                           const auto value = result.quantize(y[j], p);
+                                                           if (value)
+                                                               max = std::max(max, *value);
+                                                           else
+                                                               lossless = true;
+                                                       });
+                             }
+                             if (lossless)
+                             {
+                                 max = 0;
+                                 result.for_each_point(comp, y_fit, k, [&](std::size_t j, T p)
+                                                       { max = std::max(max, encode_lossless(y[j], p)); });
+                             }
+                             result.width[k] = static_cast<std::uint8_t>(std::bit_width(max));
+                             if (lossless && result.step != T(0))
+                                 result.width[k] |= lossless_flag;
+                         });
+
+            // 2. pack the residuals, every segment starts at a new word
+            const auto offset = result.get_offset(comp);
+            result.data.assign(offset.back(), 0);
+            parallel_for(n_threads, n_seg, [&](std::size_t k)
+                         {
+                             const auto w = result.get_width(k);
+                             if (w == 0)
+                                 return;
+                             const bool lossless = result.is_lossless(k);
+                             auto *words = result.data.data() + offset[k];
+                             std::size_t bit = 0;
+                             result.for_each_point(comp, y_fit, k, [&](std::size_t j, T p)
+                                                   {
+                                                       const auto value = lossless ? encode_lossless(y[j], p)
+                                                                                   : *result.quantize(y[j], p);
+                                                       const auto i = bit / word_bits;
+                                                       const auto shift = bit % word_bits;
+                                                       words[i] |= value << shift;
+                                                       if (shift + w > word_bits)
+                                                           words[i + 1] |= value >> (word_bits - shift);
+                                                       bit += w;
+                                                   });
+                         });
+            return result;
+        }
+
+        /**
+         * @brief Decode the timeseries
+         *
+         * @param comp fitted compressor (same positions as for Encode)
+         * @param y_fit compressed timeseries (same as for Encode)
+         * @param n_threads number of threads
+         * @return std::vector<T> original timeseries (within max_error)
+         */
+        std::vector<T> Decode(const Compressor<T> &comp,
+                              const std::vector<T> &y_fit,
+                              std::size_t n_threads = 1) const
+        {
+            check_size(comp, y_fit);
+            const auto n_seg = comp.GetPos().size() - 1;
+            if (width.size() != n_seg)
+                throw InvalidSize();
+            const auto offset = get_offset(comp);
+            if (offset.back() != data.size())
+                throw InvalidSize();
+
+            std::vector<T> y(comp.GetTimeOrigin().size());
+            parallel_for(n_threads, n_seg, [&](std::size_t k)
+                         {
+                             const auto w = get_width(k);
+                             const bool lossless = is_lossless(k);
+                             const Word mask = w == word_bits ? ~Word(0) : (Word(1) << w) - 1;
+                             const auto *words = data.data() + offset[k];
+                             std::size_t bit = 0;
+                             for_each_point(comp, y_fit, k, [&](std::size_t j, T p)
+                                            {
+                                                Word value = 0;
+                                                if (w > 0)
+                                                {
+                                                    const auto i = bit / word_bits;
+                                                    const auto shift = bit % word_bits;
+                                                    value = words[i] >> shift;
+                                                    if (shift + w > word_bits)
+                                                        value |= words[i + 1] << (word_bits - shift);
+                                                }
+                                                y[j] = lossless ? decode_lossless(value & mask, p)
+                                                                : dequantize(unzigzag(value & mask), p);
+                                                bit += w;
+                                            });
+                         });
+            return y;
+        }
+
+        /**
+         * @brief Serialize the residuals (native binary representation)
+         *
+         * @return std::string serialized data
+         */
+        std::string Serialize() const
+        {
+            std::string result;
+            auto write = [&result](const void *ptr, std::size_t size)
+            {
+                result.append(static_cast<const char *>(ptr), size);
+            };
+            const std::uint32_t header[] = {magic, version, sizeof(T), 0};
+            const std::uint64_t sizes[] = {width.size(), data.size()};
+            write(header, sizeof(header));
+            write(&step, sizeof(T));
+            write(sizes, sizeof(sizes));
+            write(width.data(), width.size());
+            write(data.data(), data.size() * sizeof(Word));
+            return result;
+        }
+
+        /**
+         * @brief Deserialize the residuals (see Serialize)
+         *
+         * @param data serialized data
+         * @return Residual
+         */
+        static Residual Deserialize(std::string_view data)
+        {
+            auto read = [&data](void *ptr, std::size_t size)
+            {
+                if (data.size() < size)
+                    throw InvalidFormat();
+                std::memcpy(ptr, data.data(), size);
+                data.remove_prefix(size);
+            };
+            Residual result;
+            std::uint32_t header[4];
+            std::uint64_t sizes[2];
+            read(header, sizeof(header));
+            read(&result.step, sizeof(T));
+            read(sizes, sizeof(sizes));
+            if (header[0] != magic || header[1] != version || header[2] != sizeof(T) ||
+                !(result.step >= T(0)) || sizes[0] > data.size() ||
+                (data.size() - sizes[0]) % sizeof(Word) != 0 ||
+                (data.size() - sizes[0]) / sizeof(Word) != sizes[1])
+                throw InvalidFormat();
+
+            result.width.resize(sizes[0]);
+            result.data.resize(sizes[1]);
+            read(result.width.data(), result.width.size());
+            read(result.data.data(), result.data.size() * sizeof(Word));
+            for (std::size_t k = 0; k < result.width.size(); ++k)
+                if (result.get_width(k) > word_bits)
+                    throw InvalidFormat();
+            return result;
+        }
+
+        /**
+         * @brief Get the size of the packed residuals in bytes
+         *
+         * @return std::size_t
+         */
+        std::size_t GetBytes() const noexcept { return data.size() * sizeof(Word) + width.size(); }
+
+        /**
+         * @brief Get the allowed error of the decoded timeseries (0: lossless)
+         *
+         * @return T
+         */
+        T GetMaxError() const noexcept { return step / 2; }
+
+    private:
+        Residual() = default;
+
+        static void check_size(const Compressor<T> &comp, const std::vector<T> &y_fit)
+        {
+            if (comp.GetPos().size() < 2 || y_fit.size() != comp.GetPos().size())
+                throw InvalidSize();
+        }
+
+        // number of points of segment k (the last segment includes the last point)
+        static std::size_t segment_size(const Compressor<T> &comp, std::size_t k)
+        {
+            const auto &pos = comp.GetPos();
+            return pos[k + 1] - pos[k] + (k + 2 == pos.size() ? 1 : 0);
+        }
+
+        // number of bits per point of segment k
+        std::size_t get_width(std::size_t k) const noexcept
+        {
+            return width[k] & ~lossless_flag;
+        }
+
+        bool is_lossless(std::size_t k) const noexcept
+        {
+            return step == T(0) || (width[k] & lossless_flag);
+        }
+
+        // first word of every segment (and the total number of words)
+        std::vector<std::size_t> get_offset(const Compressor<T> &comp) const
+        {
+            std::vector<std::size_t> offset(width.size() + 1, 0);
+            for (std::size_t k = 0; k < width.size(); ++k)
+            {
+                const auto bits = get_width(k) * segment_size(comp, k);
+                offset[k + 1] = offset[k] + (bits + word_bits - 1) / word_bits;
+            }
+            return offset;
+        }
+
+        // func(j, prediction) for every point j of segment k
+        template <typename Func>
+        void for_each_point(const Compressor<T> &comp, const std::vector<T> &y_fit,
+                            std::size_t k, Func &&func) const
+        {
+            const auto &t = comp.GetTimeOrigin();
+            const auto &pos = comp.GetPos();
+            const auto i0 = pos[k];
+            const auto i1 = pos[k + 1];
+            const auto dt = t[i1] - t[i0];
+            const auto m = dt == T(0) ? T(0) : (y_fit[k + 1] - y_fit[k]) / dt;
+            const auto end = i0 + segment_size(comp, k);
+            for (std::size_t j = i0; j < end; ++j)
+            {
+                // std::fma is exact, so the prediction does not depend on
+                // the floating point contraction of the compiler
+                func(j, std::fma(t[j] - t[i0], m, y_fit[k]));
+            }
+        }
+
+        static Word encode_lossless(T y, T p) noexcept
+        {
+            const auto diff = static_cast<Bits>(ordered(y) - ordered(p));
+            return zigzag(static_cast<std::make_signed_t<Bits>>(diff));
+        }
+
+        static T decode_lossless(Word value, T p) noexcept
+        {
+            const auto diff = static_cast<Bits>(unzigzag(value));
+            return bit_cast<T>(ordered(static_cast<Bits>(ordered(p) + diff)));
+        }
+
+        // std::nullopt if no quantized value is within max_error
+        std::optional<Word> quantize(T y, T p) const
+        {
+            const auto q = std::round((y - p) / step);
+            if (!(std::abs(q) < T(std::int64_t(1) << 52)))
+                return std::nullopt;
+
+            // the rounding of the decoded value may exceed the bound
+            const auto max_error = step / 2;
+            for (const auto candidate : {q, q - 1, q + 1})
+            {
+                const auto value = static_cast<std::int64_t>(candidate);
+                if (std::abs(dequantize(value, p) - y) <= max_error)
+                    return zigzag(value);
+            }
+            return std::nullopt;
+        }
+
+        T dequantize(std::int64_t q, T p) const
+        {
+            // same rounding for encode and decode (no contraction)
+            return std::fma(T(q), step, p);
+        }
+
+        // std::bit_cast, which needs GCC >= 11 (the python module is still
+        // built with g++-10, only the command line tool needs GCC 11)
+        template <typename To, typename From>
+        static To bit_cast(const From &value) noexcept
+        {
+            static_assert(sizeof(To) == sizeof(From));
+            To result;
+            std::memcpy(&result, &value, sizeof(To));
+            return result;
+        }
+
+        // bits of a value as two's complement integer in the order of the
+        // values (the magnitude bits of negative values are flipped), so the
+        // difference is the number of values in between, e.g. 1 for -0 and +0
+        static Bits ordered(T value) noexcept
+        {
+            return ordered(bit_cast<Bits>(value));
+        }
+
+        // the mapping is its own inverse
+        static Bits ordered(Bits bits) noexcept
+        {
+            constexpr auto sign = Bits(1) << (sizeof(Bits) * 8 - 1);
+            return bits & sign ? bits ^ (sign - 1) : bits;
+        }
+
+        static Word zigzag(std::int64_t value) noexcept
+        {
+            return (static_cast<Word>(value) << 1) ^ static_cast<Word>(value >> 63);
+        }
+
+        static std::int64_t unzigzag(Word value) noexcept
+        {
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+
+        // func(k) for k = 0, ..., n - 1, split into n_threads blocks
+        template <typename Func>
+        static void parallel_for(std::size_t n_threads, std::size_t n, const Func &func)
+        {
+            n_threads = std::clamp<std::size_t>(n_threads, 1, std::max<std::size_t>(n, 1));
+            auto block = [&](std::size_t b)
+            {
+                for (std::size_t k = n * b / n_threads; k < n * (b + 1) / n_threads; ++k)
+                    func(k);
+            };
+            std::vector<std::future<void>> futures;
+            for (std::size_t b = 1; b < n_threads; ++b)
+                futures.push_back(std::async(std::launch::async, block, b));
+            block(0);
+            for (auto &future : futures)
+                future.get();
+        }
+
+    private:
+        static constexpr std::uint32_t magic = 0x5352434d; // "MCRS"
+        static constexpr std::uint32_t version = 1;
+        static constexpr std::uint8_t lossless_flag = 0x80;
+
+        T step = T(0);
+        std::vector<std::uint8_t> width;
+        std::vector<Word> data;
+    };
+
+} // namespace measCompress
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef MEASCOMPRESS_TRIDIAGONAL_HPP
+#define MEASCOMPRESS_TRIDIAGONAL_HPP
+
+#include <vector>
+#include <span>
+
+#include <string>
+#include <exception>
+
+namespace measCompress
+{
+    /**
+     * @brief Tridiagonal system of linear equations
+     *
+     * The matrix is factorized once in the constructor (Thomas algorithm,
+     * without pivoting), so any number of right hand sides can be solved in
+     * O(n) each. Intended for diagonally dominant or symmetric positive
+     * definite matrices.
+     *
+     * @tparam T double (default)
+     */
+    template <typename T = double>
+    class Tridiagonal
+    {
+    public:
+        /**
+        * @brief Base exceptions class
+        */
+        class Exception : public std::exception
+        {
+        public:
+            Exception(std::string data) : data(std::move(data)) {}
+            const char *what() const noexcept override
+            {
+                return data.c_str();
+            }
+
+        protected:
+            std::string data;
+        };
+
+        /**
+         * @brief Invalid sizes exception
+         *
+         * e.g. the diagonal is empty or the size of a vector does not match
+         */
+        class InvalidSize : public Exception
+        {
+        public:
+            InvalidSize() : Exception("invalid size of the tridiagonal system") {}
+        };
+
+        /**
+         * @brief Singular matrix exception
+         */
+        class Singular : public Exception
+        {
+        public:
+            Singular() : Exception("tridiagonal matrix is singular") {}
+        };
+
+    public:
+        /**
+         * @brief Construct and factorize a new Tridiagonal object
+         *
+         * @param lower subdiagonal, lower[i] = A(i + 1, i) (size n - 1)
+         * @param diag diagonal, diag[i] = A(i, i) (size n)
+         * @param upper superdiagonal, upper[i] = A(i, i + 1) (size n - 1)
+         */
+        Tridiagonal(std::vector<T> lower, std::vector<T> diag, std::vector<T> upper)
+            : lower(std::move(lower)),
+              upper(std::move(upper)),
+              pivot(std::move(diag))
+        {
+            const auto n = pivot.size();
+            if (n == 0 || this->lower.size() != n - 1 || this->upper.size() != n - 1)
+            {
+                throw InvalidSize();
+            }
+
+            // pivot[i] = diag[i] - lower[i - 1] * upper[i - 1] / pivot[i - 1]
+            // upper[i] = upper[i] / pivot[i]
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (i > 0)
+                    pivot[i] -= this->lower[i - 1] * this->upper[i - 1];
+                if (pivot[i] == T(0))
+                    throw Singular();
+                if (i + 1 < n)
+                    this->upper[i] /= pivot[i];
+            }
+        }
+
+        /**
+         * @brief Solve the system A * x = rhs
+         *
+         * @param rhs right hand side, will be overwritten with the solution x
+         */
+        void Solve(std::span<T> rhs) const
+        {
+            const auto n = pivot.size();
+            if (rhs.size() != n)
+            {
+                throw InvalidSize();
+            }
+
+            rhs[0] /= pivot[0];
+            for (std::size_t i = 1; i < n; ++i)
+                rhs[i] = (rhs[i] - lower[i - 1] * rhs[i - 1]) / pivot[i];
+            for (std::size_t i = n - 1; i > 0; --i)
+                rhs[i - 1] -= upper[i - 1] * rhs[i];
+        }
+
+        /**
+         * @brief Get the number of unknowns
+         *
+         * @return std::size_t
+         */
+        std::size_t GetSize() const noexcept { return pivot.size(); }
+
+    private:
+        std::vector<T> lower;
+        std::vector<T> upper;
+        std::vector<T> pivot;
+    };
+
+} // namespace measCompress
+
+#endif
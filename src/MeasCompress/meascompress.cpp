@@ -0,0 +1,464 @@
+// Command line interface: compress measurement files without python
+//
+// Every file is processed by a pipeline of three threads (read -> fit ->
+// write), several files are processed concurrently.
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <variant>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+
+#include "chunk_compressor.hpp"
+#include "reader.hpp"
+
+namespace
+{
+    using T = double;
+    using Columns = std::vector<std::vector<T>>;
+    using Reader = std::variant<measCompress::CsvReader<T>, measCompress::BinaryReader<T>>;
+
+    constexpr auto usage = R"(usage: meascompress [options] file...
+
+Compress measurement files by removing points which are approximately on a
+line. Every input file <name> is written to <name>.mc.csv (or <name>.mc.bin
+for binary input).
+
+options:
+  -t, --tol [COL=]TOL   tolerance of column COL (name or index), without COL
+                        the tolerance is used for all other columns;
+                        columns without tolerance are only transformed
+  --time COL            time column (name or index, default: 0)
+  --continuous          continuous least squares fit at the compressed
+                        points instead of averaging the lines of adjacent
+                        segments (fitted chunk by chunk, the values at the
+                        first row of a chunk are kept from the previous one)
+  --binary N            input is raw binary (native double, row by row)
+                        with N columns
+  -d, --delimiter C     CSV delimiter (default: ',')
+  -o, --output DIR      output directory (default: next to the input)
+  -c, --chunk ROWS      rows per chunk (default: 1048576)
+  -j, --jobs N          number of files processed concurrently
+                        (default: number of cores / 3)
+  -q, --quiet           no throughput summary
+  -h, --help            show this help
+)";
+
+    /**
+     * @brief Invalid command line exception
+     */
+    class UsageError : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    struct Options
+    {
+        std::vector<std::pair<std::string, T>> tolerances;
+        std::optional<T> default_tolerance;
+        std::string time_column = "0";
+        bool continuous = false;
+        std::size_t binary_columns = 0;
+        char delimiter = ',';
+        std::optional<std::filesystem::path> output_dir;
+        std::size_t chunk_rows = std::size_t(1) << 20;
+        std::size_t jobs = std::max(1u, std::thread::hardware_concurrency() / 3);
+        bool quiet = false;
+        std::vector<std::filesystem::path> files;
+    };
+
+    struct Statistic
+    {
+        std::size_t bytes_in = 0;
+        std::size_t rows_in = 0;
+        std::size_t rows_out = 0;
+    };
+
+    /**
+     * @brief Bounded queue connecting two stages of the pipeline
+     *
+     * Push blocks while the queue is full, Pop blocks while the queue is
+     * empty. After Close, Push fails and Pop returns the remaining elements.
+     */
+    template <typename V>
+    class Channel
+    {
+    public:
+        explicit Channel(std::size_t capacity) : capacity(capacity) {}
+
+        bool Push(V value)
+        {
+            std::unique_lock lock(mutex);
+            cv_push.wait(lock, [this]
+                         { return closed || queue.size() < capacity; });
+            if (closed)
+                return false;
+            queue.push_back(std::move(value));
+            cv_pop.notify_one();
+            return true;
+        }
+
+        std::optional<V> Pop()
+        {
+            std::unique_lock lock(mutex);
+            cv_pop.wait(lock, [this]
+                        { return closed || !queue.empty(); });
+            if (queue.empty())
+                return std::nullopt;
+            auto value = std::move(queue.front());
+            queue.pop_front();
+            cv_push.notify_one();
+            return value;
+        }
+
+        void Close()
+        {
+            std::lock_guard lock(mutex);
+            closed = true;
+            cv_push.notify_all();
+            cv_pop.notify_all();
+        }
+
+    private:
+        std::size_t capacity;
+        std::deque<V> queue;
+        bool closed = false;
+        std::mutex mutex;
+        std::condition_variable cv_push;
+        std::condition_variable cv_pop;
+    };
+
+    template <typename V>
+    V parse_number(std::string_view str, std::string_view what)
+    {
+        V value{};
+        const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+        if (ec != std::errc() || ptr != str.data() + str.size())
+            throw UsageError("invalid " + std::string(what) + ": '" + std::string(str) + "'");
+        return value;
+    }
+
+    Options parse_options(int argc, char **argv)
+    {
+        Options opt;
+        auto value = [&](int &i)
+        {
+            if (i + 1 >= argc)
+                throw UsageError(std::string("missing value for ") + argv[i]);
+            return std::string_view(argv[++i]);
+        };
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (arg == "-h" || arg == "--help")
+            {
+                std::cout << usage;
+                std::exit(0);
+            }
+            else if (arg == "-t" || arg == "--tol")
+            {
+                const auto spec = value(i);
+                const auto pos = spec.rfind('=');
+                if (pos == std::string_view::npos)
+                    opt.default_tolerance = parse_number<T>(spec, "tolerance");
+                else
+                    opt.tolerances.emplace_back(std::string(spec.substr(0, pos)),
+                                                parse_number<T>(spec.substr(pos + 1), "tolerance"));
+            }
+            else if (arg == "--time")
+                opt.time_column = value(i);
+            else if (arg == "--continuous")
+                opt.continuous = true;
+            else if (arg == "--binary")
+                opt.binary_columns = parse_number<std::size_t>(value(i), "number of columns");
+            else if (arg == "-d" || arg == "--delimiter")
+            {
+                const auto d = value(i);
+                if (d.size() != 1)
+                    throw UsageError("delimiter must be a single character");
+                opt.delimiter = d.front();
+            }
+            else if (arg == "-o" || arg == "--output")
+                opt.output_dir = std::filesystem::path(value(i));
+            else if (arg == "-c" || arg == "--chunk")
+                opt.chunk_rows = parse_number<std::size_t>(value(i), "chunk size");
+            else if (arg == "-j" || arg == "--jobs")
+                opt.jobs = parse_number<std::size_t>(value(i), "number of jobs");
+            else if (arg == "-q" || arg == "--quiet")
+                opt.quiet = true;
+            else if (arg.starts_with("-") && arg.size() > 1)
+                throw UsageError("unknown option '" + std::string(arg) + "'");
+            else
+                opt.files.emplace_back(arg);
+        }
+
+        if (opt.files.empty())
+            throw UsageError("no input file");
+        if (opt.tolerances.empty() && !opt.default_tolerance)
+            throw UsageError("no tolerance defined");
+        if (opt.chunk_rows < 2)
+            throw UsageError("chunk size must be >= 2");
+        opt.jobs = std::max<std::size_t>(1, opt.jobs);
+        return opt;
+    }
+
+    std::size_t find_column(const std::vector<std::string> &names,
+                            const std::string &column)
+    {
+        for (std::size_t i = 0; i < names.size(); ++i)
+            if (names[i] == column)
+                return i;
+
+        std::size_t index = 0;
+        const auto [ptr, ec] = std::from_chars(column.data(), column.data() + column.size(), index);
+        if (ec == std::errc() && ptr == column.data() + column.size() && index < names.size())
+            return index;
+        throw std::runtime_error("unknown column '" + column + "'");
+    }
+
+    /**
+     * @brief Compress a single file with a read -> fit -> write pipeline
+     *
+     * The input is split into chunks of Options::chunk_rows rows, which are
+     * compressed with a ChunkCompressor.
+     */
+    Statistic compress_file(const Options &opt, const std::filesystem::path &file)
+    {
+        const bool binary = opt.binary_columns > 0;
+        std::ifstream in(file, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("cannot open '" + file.string() + "'");
+
+        Reader reader = binary ? Reader(std::in_place_index<1>, in, opt.binary_columns)
+                               : Reader(std::in_place_index<0>, in, opt.delimiter);
+        const auto names = std::visit([](const auto &r)
+                                      { return r.GetNames(); },
+                                      reader);
+
+        const auto time_index = find_column(names, opt.time_column);
+        std::vector<std::optional<T>> tolerances(names.size());
+        for (std::size_t i = 0; i < names.size(); ++i)
+            if (i != time_index)
+                tolerances[i] = opt.default_tolerance;
+        for (const auto &[column, tol] : opt.tolerances)
+        {
+            const auto index = find_column(names, column);
+            if (index == time_index)
+                throw std::runtime_error("the time column '" + column + "' has no tolerance");
+            tolerances[index] = tol;
+        }
+
+        auto out_path = file;
+        out_path += binary ? ".mc.bin" : ".mc.csv";
+        if (opt.output_dir)
+            out_path = *opt.output_dir / out_path.filename();
+        std::ofstream out(out_path, std::ios::binary);
+        if (!out)
+            throw std::runtime_error("cannot open '" + out_path.string() + "'");
+
+        Statistic stat;
+        Channel<Columns> to_fit(2);
+        Channel<Columns> to_write(2);
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto fail = [&]()
+        {
+            std::lock_guard lock(error_mutex);
+            if (!error)
+                error = std::current_exception();
+            to_fit.Close();
+            to_write.Close();
+        };
+
+        std::thread read_thread([&]()
+        {
+            try
+            {
+                Columns columns;
+                while (true)
+                {
+                    const auto rows = std::visit([&](auto &r)
+                                                 { return r.Read(columns, opt.chunk_rows); },
+                                                 reader);
+                    if (rows == 0)
+                        break;
+                    stat.rows_in += rows;
+
+                    if (!to_fit.Push(std::move(columns)))
+                        return;
+                    columns = Columns();
+                }
+                to_fit.Close();
+            }
+            catch (...)
+            {
+                fail();
+            }
+        });
+
+        std::thread fit_thread([&]()
+        {
+            try
+            {
+                measCompress::ChunkCompressor<T> chunks(tolerances, time_index, opt.continuous);
+                while (auto columns = to_fit.Pop())
+                {
+                    if (!to_write.Push(chunks.Compress(std::move(*columns))))
+                        return;
+                }
+                // a previous error of the pipeline is kept by fail()
+                chunks.Finish();
+                to_write.Close();
+            }
+            catch (...)
+            {
+                fail();
+            }
+        });
+
+        std::thread write_thread([&]()
+        {
+            try
+            {
+                if (!binary)
+                {
+                    for (std::size_t i = 0; i < names.size(); ++i)
+                        out << (i == 0 ? "" : std::string(1, opt.delimiter)) << names[i];
+                    out << '\n';
+                }
+
+                std::vector<char> buffer;
+                while (auto columns = to_write.Pop())
+                {
+                    const auto rows = columns->front().size();
+                    buffer.clear();
+                    for (std::size_t j = 0; j < rows; ++j)
+                    {
+                        for (std::size_t i = 0; i < columns->size(); ++i)
+                        {
+                            const auto value = (*columns)[i][j];
+                            if (binary)
+                            {
+                                const auto *bytes = reinterpret_cast<const char *>(&value);
+                                buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+                                continue;
+                            }
+                            char str[32];
+                            const auto [ptr, ec] = std::to_chars(str, str + sizeof(str), value);
+                            if (i != 0)
+                                buffer.push_back(opt.delimiter);
+                            buffer.insert(buffer.end(), str, ptr);
+                        }
+                        if (!binary)
+                            buffer.push_back('\n');
+                    }
+                    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                    if (!out)
+                        throw std::runtime_error("cannot write '" + out_path.string() + "'");
+                    stat.rows_out += rows;
+                }
+            }
+            catch (...)
+            {
+                fail();
+            }
+        });
+
+        read_thread.join();
+        fit_thread.join();
+        write_thread.join();
+        if (error)
+        {
+            out.close();
+            std::filesystem::remove(out_path);
+            std::rethrow_exception(error);
+        }
+
+        stat.bytes_in = static_cast<std::size_t>(std::filesystem::file_size(file));
+        return stat;
+    }
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    try
+    {
+        opt = parse_options(argc, argv);
+    }
+    catch (const UsageError &e)
+    {
+        std::cerr << "meascompress: " << e.what() << "\n\n"
+                  << usage;
+        return 2;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    Statistic total;
+    std::atomic<std::size_t> next_file = 0;
+    std::atomic<bool> failed = false;
+    std::mutex output_mutex;
+
+    std::vector<std::thread> workers;
+    for (std::size_t j = 0; j < std::min(opt.jobs, opt.files.size()); ++j)
+    {
+        workers.emplace_back([&]()
+        {
+            for (auto i = next_file++; i < opt.files.size(); i = next_file++)
+            {
+                const auto &file = opt.files[i];
+                const auto file_start = std::chrono::steady_clock::now();
+                try
+                {
+                    const auto stat = compress_file(opt, file);
+                    const std::chrono::duration<double> sec =
+                        std::chrono::steady_clock::now() - file_start;
+
+                    std::lock_guard lock(output_mutex);
+                    total.bytes_in += stat.bytes_in;
+                    total.rows_in += stat.rows_in;
+                    total.rows_out += stat.rows_out;
+                    if (!opt.quiet)
+                        std::cerr << file.string() << ": " << stat.rows_in << " -> "
+                                  << stat.rows_out << " rows, " << sec.count() << " s\n";
+                }
+                catch (const std::exception &e)
+                {
+                    failed = true;
+                    std::lock_guard lock(output_mutex);
+                    std::cerr << "meascompress: " << file.string() << ": " << e.what() << '\n';
+                }
+            }
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+
+    if (!opt.quiet)
+    {
+        const std::chrono::duration<double> sec = std::chrono::steady_clock::now() - start;
+        const auto ratio = total.rows_in == 0 ? 0.0 : double(total.rows_out) / double(total.rows_in);
+        std::cerr << "total: " << opt.files.size() << " file(s), "
+                  << total.rows_in << " -> " << total.rows_out << " rows ("
+                  << ratio * 100 << " %), " << sec.count() << " s, "
+                  << total.bytes_in / sec.count() / 1e6 << " MB/s, "
+                  << total.rows_in / sec.count() / 1e6 << " Mrows/s\n";
+    }
+    return failed ? 1 : 0;
+}
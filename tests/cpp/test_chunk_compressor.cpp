@@ -0,0 +1,130 @@
+#include "catch2/catch.hpp"
+#include "chunk_compressor.hpp"
+
+#include <vector>
+#include <optional>
+#include <cmath>
+
+using namespace measCompress;
+using T = double;
+using Columns = ChunkCompressor<T>::Columns;
+
+namespace
+{
+    // rows [begin, end) of the columns
+    Columns rows(const Columns &columns, std::size_t begin, std::size_t end)
+    {
+        Columns result;
+        for (const auto &column : columns)
+            result.emplace_back(column.begin() + begin, column.begin() + end);
+        return result;
+    }
+
+    void equal(const Columns &a, const Columns &b)
+    {
+        REQUIRE(a.size() == b.size());
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            REQUIRE(a[i].size() == b[i].size());
+            for (std::size_t j = 0; j < a[i].size(); ++j)
+                REQUIRE(a[i][j] == Approx(b[i][j]).margin(1e-12));
+        }
+    }
+
+    // compress the columns in chunks of the given sizes
+    Columns compress(const Columns &columns, const std::vector<std::size_t> &sizes,
+                     bool continuous = false)
+    {
+        ChunkCompressor<T> chunks({std::nullopt, T(0.1), std::nullopt}, 0, continuous);
+        Columns result(columns.size());
+        std::size_t begin = 0;
+        for (auto size : sizes)
+        {
+            auto part = chunks.Compress(rows(columns, begin, begin + size));
+            for (std::size_t i = 0; i < columns.size(); ++i)
+                result[i].insert(result[i].end(), part[i].begin(), part[i].end());
+            begin += size;
+        }
+        return result;
+    }
+}
+
+TEST_CASE("constructor chunk compressor", "[measCompress, chunk_compressor]")
+{
+    REQUIRE_THROWS_AS(ChunkCompressor<T>({T(0.1)}, 1),
+                      ChunkCompressor<T>::InvalidSize);
+
+    ChunkCompressor<T> chunks({std::nullopt, T(0.1)}, 0);
+    REQUIRE_THROWS_AS(chunks.Compress({{1, 2}}),
+                      ChunkCompressor<T>::InvalidSize);
+    REQUIRE_THROWS_AS(chunks.Compress({{1, 2}, {1}}),
+                      ChunkCompressor<T>::InvalidSize);
+    REQUIRE_THROWS_AS(chunks.Compress({{1}, {1}}),
+                      ChunkCompressor<T>::TooFewRows);
+
+    // no rows at all
+    REQUIRE_THROWS_AS(chunks.Finish(), ChunkCompressor<T>::TooFewRows);
+    chunks.Compress({{1, 2}, {1, 2}});
+    chunks.Finish();
+}
+
+TEST_CASE("compress chunks", "[measCompress, chunk_compressor]")
+{
+    // breakpoints at 0, 3, 6, 9
+    Columns columns = {
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+        {0, 1, 2, 3, 3, 3, 3, 2, 1, 0},
+        {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}};
+    const Columns expected = {{0, 3, 6, 9}, {0, 3, 3, 0}, {1, 4, 7, 10}};
+
+    equal(compress(columns, {10}), expected);
+    equal(compress(columns, {10}, true), expected);
+
+    // chunk boundaries at the breakpoints: same rows and join values
+    equal(compress(columns, {4, 3, 3}), expected);
+    equal(compress(columns, {4, 3, 3}, true), expected);
+    equal(compress(columns, {7, 3}), expected);
+
+    // a chunk with a single row adds the shared row only once
+    equal(compress(columns, {4, 3, 2, 1}),
+          {{0, 3, 6, 8, 9}, {0, 3, 3, 1, 0}, {1, 4, 7, 9, 10}});
+
+    // other chunk boundaries are additional points
+    auto result = compress(columns, {2, 2, 2, 2, 2});
+    REQUIRE(result[0] == std::vector<T>{0, 1, 3, 5, 6, 7, 9});
+    for (std::size_t j = 0; j < result[0].size(); ++j)
+    {
+        const auto i = static_cast<std::size_t>(result[0][j]);
+        REQUIRE(result[1][j] == Approx(columns[1][i]).margin(1e-12));
+        REQUIRE(result[2][j] == Approx(columns[2][i]));
+    }
+}
+
+TEST_CASE("compress chunks continuous", "[measCompress, chunk_compressor]")
+{
+    // not exact at the breakpoints
+    Columns columns(3);
+    for (std::size_t i = 0; i < 40; ++i)
+    {
+        const auto x = T(i);
+        columns[0].push_back(x);
+        columns[1].push_back((i < 25 ? x : 50 - x) + 0.05 * std::sin(T(i)));
+        columns[2].push_back(2 * x);
+    }
+    const auto result = compress(columns, {20, 20}, true);
+
+    // the first chunk is fitted on its own
+    const auto first = rows(columns, 0, 20);
+    auto comp = Compressor<T>().Fit(first[0], {Dependency<T>(first[1], T(0.1))});
+    const auto n = comp.GetPos().size();
+    equal(rows(result, 0, n), comp.TransformContinuous(first));
+
+    // the second chunk keeps the returned values of the shared row
+    const auto second = rows(columns, 19, 40);
+    std::vector<T> shared;
+    for (const auto &column : result)
+        shared.push_back(column[n - 1]);
+    comp.Fit(second[0], {Dependency<T>(second[1], T(0.1))});
+    const auto expected = comp.TransformContinuous(second, shared);
+    equal(rows(result, n - 1, result[0].size()), expected);
+}
@@ -2,6 +2,12 @@
 #include "compressor.hpp"
 
 #include <vector>
+#include <span>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <cstring>
+#include <cstdint>
 
 using namespace measCompress;
 using T = double;
@@ -68,3 +74,365 @@ TEST_CASE("fit measurement", "[measCompress, compressor]")
         equal(compress.TransformNoFit(t), compress.GetTimeFit());
     }
 }
+
+namespace
+{
+    // user defined error norm: every point below the tolerance
+    class PointError
+    {
+    public:
+        explicit PointError(T tol) : tol(tol) {}
+        bool IsValid() const noexcept { return tol >= T(0); }
+        bool Check(const Line<T> &line, std::span<const T> t, std::span<const T> y) const
+        {
+            for (std::size_t i = 0; i < t.size(); ++i)
+                if (!(std::abs(y[i] - line.GetY(t[i])) < tol))
+                    return false;
+            return true;
+        }
+
+    private:
+        T tol;
+    };
+}
+
+TEST_CASE("fit measurement with different error norms", "[measCompress, compressor]")
+{
+    std::vector<T> t = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<T> y1 = {0, 1, 2, 3, 3, 3, 3, 2, 1, 0};
+    std::vector<T> y2 = {1, 2, 4, 8, 16, 32, 64, 128, 256, 512};
+
+    {
+        Dependency<T> dep1(y1, T(0.1));
+        auto compress = Compressor<T>().Fit(t, {dep1});
+        equal(compress.GetTimeFit(), {0, 3, 6, 9});
+    }
+    {
+        Dependency<T> dep1(y1, T(0.1));
+        Dependency<T, RelMaxError<T>> dep2(y2, T(0.5));
+        auto compress = Compressor<T>().Fit(t, {dep2});
+        REQUIRE(compress.GetPos() == std::vector<std::size_t>{0, 2, 4, 6, 8, 9});
+
+        // every segment has to satisfy both norms
+        compress = Compressor<T>().Fit(t, {dep1, dep2});
+        REQUIRE(compress.GetPos() == std::vector<std::size_t>{0, 2, 3, 5, 6, 8, 9});
+    }
+    {
+        // exactly fitted zeros are within a relative tolerance
+        std::vector<T> t0(1000), zero(1000, T(0)), ramp(1000);
+        for (std::size_t i = 0; i < t0.size(); ++i)
+        {
+            t0[i] = T(i);
+            ramp[i] = i < 500 ? T(0) : T(i - 500);
+        }
+        Dependency<T, RelMaxError<T>> dep_zero(zero, T(0.01));
+        REQUIRE(Compressor<T>().Fit(t0, {dep_zero}).GetPos() == std::vector<std::size_t>{0, 999});
+        Dependency<T, RelMaxError<T>> dep_ramp(ramp, T(0.01));
+        REQUIRE(Compressor<T>().Fit(t0, {dep_ramp}).GetPos() == std::vector<std::size_t>{0, 500, 999});
+    }
+    {
+        // a single error norm without AnyDependency
+        std::vector<Dependency<T>> deps = {Dependency<T>(y1, T(0.1))};
+        REQUIRE(Compressor<T>().Fit(t, deps).GetPos() == std::vector<std::size_t>{0, 3, 6, 9});
+
+        // a user defined error norm, alone and combined
+        Dependency<T, PointError> dep1(y1, T(0.1));
+        Dependency<T, RelMaxError<T>> dep2(y2, T(0.5));
+        std::vector<Dependency<T, PointError>> user = {dep1};
+        REQUIRE(Compressor<T>().Fit(t, user).GetPos() == std::vector<std::size_t>{0, 3, 6, 9});
+        REQUIRE(Compressor<T>().Fit(t, {dep1, dep2}).GetPos() ==
+                std::vector<std::size_t>{0, 2, 3, 5, 6, 8, 9});
+    }
+}
+
+TEST_CASE("transform continuous", "[measCompress, compressor]")
+{
+    std::vector<T> t = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    std::vector<T> y1 = {1, 2, 3, 4, 4, 4, 4, 3, 2, 1};
+    std::vector<T> y2 = {0, 1.1, 2.1, 3, 3, 3, 3, 1.9, 0.9, 0};
+    Dependency<T> dep1(y1, T(0.1));
+    auto compress = Compressor<T>().Fit(t, {dep1});
+    equal(compress.GetTimeFit(), {1, 4, 7, 10});
+
+    equal(compress.TransformContinuous(y1), {1, 4, 4, 1});
+    equal(compress.TransformContinuous(t), {1, 4, 7, 10});
+    equal(compress.TransformContinuous(y2),
+          {0.0510309278, 3.0463917526, 2.9536082474, -0.0510309278});
+
+    auto result = compress.TransformContinuous(std::vector<std::vector<T>>{y1, y2});
+    REQUIRE(result.size() == 2);
+    equal(result[0], compress.TransformContinuous(y1));
+    equal(result[1], compress.TransformContinuous(y2));
+
+    REQUIRE_THROWS_AS(compress.TransformContinuous({1, 2, 3}),
+                      Compressor<T>::InvalidSize);
+
+    // given values at the first point, the others are fitted for them
+    result = compress.TransformContinuous(std::vector<std::vector<T>>{y1, y2}, {1, 0.5});
+    equal(result[0], {1, 4, 4, 1});
+    equal(result[1], {0.5, 2.9471939903, 2.9758285462, -0.0573795846});
+
+    result = compress.TransformContinuous(std::vector<std::vector<T>>{y2}, {0.0510309278});
+    equal(result[0], compress.TransformContinuous(y2));
+
+    REQUIRE_THROWS_AS(compress.TransformContinuous(std::vector<std::vector<T>>{y1, y2}, {1}),
+                      Compressor<T>::InvalidSize);
+}
+
+TEST_CASE("fit measurement with progress", "[measCompress, compressor]")
+{
+    std::vector<T> t = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<T> y = {0, 1, 2, 3, 3, 3, 3, 2, 1, 0};
+    Dependency<T> dep1(y, T(0.1));
+
+    {
+        std::vector<std::size_t> done;
+        Progress progress([&](std::size_t d, std::size_t total)
+                          {
+                              REQUIRE(total == 10);
+                              done.push_back(d);
+                          },
+                          1);
+        auto compress = Compressor<T>().Fit(t, {dep1}, progress);
+        equal(compress.GetTimeFit(), {0, 3, 6, 9});
+        REQUIRE(!done.empty());
+        REQUIRE(std::is_sorted(done.begin(), done.end()));
+        REQUIRE(done.back() == 10);
+
+        // the same object reports the next computation from the start
+        done.clear();
+        equal(compress.Transform(y, progress), {0, 3, 3, 0});
+        REQUIRE(done == std::vector<std::size_t>{4, 7, 10});
+    }
+    {
+        // one pass for the matrix and one per timeseries
+        std::vector<std::pair<std::size_t, std::size_t>> done;
+        Progress progress([&](std::size_t d, std::size_t total)
+                          { done.emplace_back(d, total); },
+                          1);
+        auto compress = Compressor<T>().Fit(t, {dep1});
+        compress.TransformContinuous(std::vector<std::vector<T>>{y, y}, progress);
+        REQUIRE(done == std::vector<std::pair<std::size_t, std::size_t>>{
+                            {10, 30}, {20, 30}, {30, 30}});
+    }
+    {
+        CancelToken token;
+        token.Cancel();
+        REQUIRE_THROWS_AS(Compressor<T>().Fit(t, {dep1}, token),
+                          Compressor<T>::Cancelled);
+
+        auto compress = Compressor<T>().Fit(t, {dep1});
+        REQUIRE_THROWS_AS(compress.Transform(y, token),
+                          Compressor<T>::Cancelled);
+        REQUIRE_THROWS_AS(compress.TransformContinuous(y, token),
+                          Compressor<T>::Cancelled);
+    }
+    {
+        // cancel within the fit
+        CancelToken token;
+        Progress progress([&](std::size_t, std::size_t)
+                          { token.Cancel(); },
+                          1, token);
+        REQUIRE_THROWS_AS(Compressor<T>().Fit(t, {dep1}, progress),
+                          Compressor<T>::Cancelled);
+    }
+}
+
+TEST_CASE("fit measurement in parallel", "[measCompress, compressor]")
+{
+    // piecewise linear with kinks at 0, 1000, 3500, 3600, 10000, 19999
+    std::vector<T> t(20000);
+    std::vector<T> y(t.size());
+    for (std::size_t i = 0; i < t.size(); ++i)
+    {
+        t[i] = T(i) * 0.1;
+        y[i] = i < 1000   ? T(i)
+               : i < 3500 ? T(1000) - 0.2 * T(i - 1000)
+               : i < 3600 ? T(500) + 3 * T(i - 3500)
+               : i < 10000 ? T(800)
+                           : T(800) + 0.5 * T(i - 10000);
+    }
+    Dependency<T> dep1(y, T(0.1));
+
+    auto sequential = Compressor<T>().Fit(t, {dep1});
+    std::vector<std::size_t> expected = {0, 1000, 3500, 3600, 10000, 19999};
+    REQUIRE(sequential.GetPos() == expected);
+
+    for (std::size_t n_threads : {2, 3, 8})
+    {
+        auto parallel = Compressor<T>().SetParallel(n_threads, 16).Fit(t, {dep1});
+        REQUIRE(parallel.GetPos() == expected);
+    }
+
+    // not active for short segments
+    auto parallel = Compressor<T>().SetParallel(4, 100000).Fit(t, {dep1});
+    REQUIRE(parallel.GetPos() == expected);
+}
+
+TEST_CASE("bounded effort of the parallel fit", "[measCompress, compressor]")
+{
+    // zigzag with 100 segments of 1000 points
+    std::vector<T> t(100000);
+    std::vector<T> y(t.size());
+    for (std::size_t i = 0; i < t.size(); ++i)
+    {
+        t[i] = T(i);
+        y[i] = (i / 1000) % 2 == 0 ? T(i % 1000) : T(1000 - i % 1000);
+    }
+    Dependency<T> dep1(y, T(0.1));
+
+    auto sequential = Compressor<T>().Fit(t, {dep1});
+    REQUIRE(sequential.GetPos().size() == 101);
+    REQUIRE(sequential.GetCheckedPoints() > 0);
+
+    // the speculative checks stay close to the segment, they must not grow
+    // with the remaining length of the measurement
+    for (std::size_t n_threads : {2, 4, 8})
+    {
+        auto parallel = Compressor<T>().SetParallel(n_threads, 16).Fit(t, {dep1});
+        REQUIRE(parallel.GetPos() == sequential.GetPos());
+        REQUIRE(parallel.GetCheckedPoints() <= n_threads * sequential.GetCheckedPoints());
+    }
+}
+
+TEST_CASE("reduced latency of the parallel fit", "[measCompress, compressor]")
+{
+    // zigzag with 4 segments of 50000 points
+    std::vector<T> t(200000);
+    std::vector<T> y(t.size());
+    for (std::size_t i = 0; i < t.size(); ++i)
+    {
+        t[i] = T(i);
+        y[i] = (i / 50000) % 2 == 0 ? T(i % 50000) : T(50000 - i % 50000);
+    }
+    Dependency<T> dep1(y, T(0.1));
+
+    auto sequential = Compressor<T>().Fit(t, {dep1});
+    REQUIRE(sequential.GetPos().size() == 5);
+    REQUIRE(sequential.GetCriticalPoints() == sequential.GetCheckedPoints());
+
+    // the checks in parallel are awaited together, the critical path must
+    // not grow with the number of threads
+    auto critical = sequential.GetCriticalPoints();
+    for (std::size_t n_threads : {2, 4, 8, 64})
+    {
+        auto parallel = Compressor<T>().SetParallel(n_threads, 16).Fit(t, {dep1});
+        REQUIRE(parallel.GetPos() == sequential.GetPos());
+        REQUIRE(parallel.GetCriticalPoints() < critical);
+        critical = parallel.GetCriticalPoints();
+    }
+}
+
+TEST_CASE("construct from positions", "[measCompress, compressor]")
+{
+    std::vector<T> t = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<T> y = {0, 1.1, 2.1, 3, 3, 3, 3, 1.9, 0.9, 0};
+
+    Compressor<T> compress(t, {0, 3, 6, 9});
+    equal(compress.GetTimeFit(), {0, 3, 6, 9});
+    equal(compress.Transform(y), {0.05, 3.025, 2.975, -0.05});
+
+    auto grid = Compressor<T>::FromGrid(T(0), T(1), 10, {0, 3, 6, 9});
+    equal(grid.GetTimeOrigin(), t);
+    equal(grid.Transform(y), {0.05, 3.025, 2.975, -0.05});
+
+    REQUIRE_THROWS_AS(Compressor<T>({0}, {0}),
+                      Compressor<T>::InvalidSize);
+    for (auto pos : std::vector<std::vector<std::size_t>>{
+             {}, {0}, {1, 9}, {0, 8}, {0, 10}, {0, 3, 3, 9}, {0, 6, 3, 9}})
+    {
+        REQUIRE_THROWS_AS(Compressor<T>(t, pos),
+                          Compressor<T>::InvalidPosition);
+    }
+}
+
+TEST_CASE("serialize", "[measCompress, compressor]")
+{
+    std::vector<T> t = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<T> y = {0, 1, 2, 3, 3, 3, 3, 2, 1, 0};
+    Dependency<T> dep1(y, T(0.1));
+    auto compress = Compressor<T>().Fit(t, {dep1});
+
+    {
+        auto data = compress.Serialize();
+        auto copy = Compressor<T>::Deserialize(data);
+        REQUIRE(copy.GetPos() == compress.GetPos());
+        equal(copy.GetTimeOrigin(), t);
+    }
+    {
+        auto data = compress.Serialize(false);
+        REQUIRE(data.size() < compress.Serialize().size());
+        REQUIRE_THROWS_AS(Compressor<T>::Deserialize(data),
+                          Compressor<T>::InvalidFormat);
+
+        auto copy = Compressor<T>::Deserialize(data, t);
+        REQUIRE(copy.GetPos() == compress.GetPos());
+        equal(copy.GetTimeOrigin(), t);
+        REQUIRE_THROWS_AS(Compressor<T>::Deserialize(data, {0, 1, 2}),
+                          Compressor<T>::DifferentSize);
+    }
+    {
+        auto grid = Compressor<T>::FromGrid(T(0), T(1), 10, compress.GetPos());
+        auto data = grid.Serialize();
+        REQUIRE(data.size() == compress.Serialize(false).size() + 2 * sizeof(T));
+        auto copy = Compressor<T>::Deserialize(data);
+        REQUIRE(copy.GetPos() == compress.GetPos());
+        equal(copy.GetTimeOrigin(), t);
+
+        // the equidistant time of the fit is stored as a grid, too
+        REQUIRE(compress.Serialize() == data);
+
+        REQUIRE_THROWS_AS(Compressor<T>::FromGrid(T(0), T(1), 9, compress.GetPos()),
+                          Compressor<T>::InvalidPosition);
+    }
+    {
+        // a corrupt number of points must not be allocated
+        auto data = compress.Serialize();
+        const std::uint64_t n = std::uint64_t(1) << 60;
+        std::memcpy(data.data() + 4 * sizeof(std::uint32_t), &n, sizeof(n));
+        REQUIRE_THROWS_AS(Compressor<T>::Deserialize(data),
+                          Compressor<T>::InvalidFormat);
+
+        // a forged grid with matching positions {0, n - 1}
+        data = Compressor<T>::FromGrid(T(0), T(1), 10, {0, 9}).Serialize();
+        const std::uint64_t forged[] = {std::uint64_t(1) << 40, 2, 0, (std::uint64_t(1) << 40) - 1};
+        std::memcpy(data.data() + 4 * sizeof(std::uint32_t), forged, sizeof(forged));
+        REQUIRE_THROWS_AS(Compressor<T>::Deserialize(data),
+                          Compressor<T>::InvalidFormat);
+
+        // the limit of the grid size
+        data = Compressor<T>::FromGrid(T(0), T(1), 10, {0, 9}).Serialize();
+        REQUIRE_THROWS_AS(Compressor<T>::Deserialize(data, 9),
+                          Compressor<T>::InvalidFormat);
+        REQUIRE(Compressor<T>::Deserialize(data, 10).GetPos() == std::vector<std::size_t>{0, 9});
+    }
+    {
+        // not fitted
+        auto data = Compressor<T>().Serialize();
+        REQUIRE(Compressor<T>::Deserialize(data).GetPos().empty());
+        REQUIRE(Compressor<T>::Deserialize(data, std::vector<T>()).GetPos().empty());
+        REQUIRE_THROWS_AS(Compressor<T>::Deserialize(data, t),
+                          Compressor<T>::DifferentSize);
+    }
+    {
+        std::vector<T> t2 = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9.5};
+        auto fitted = Compressor<T>().Fit(t2, {dep1});
+        auto data = fitted.Serialize();
+        REQUIRE(data.size() == fitted.Serialize(false).size() + t2.size() * sizeof(T));
+        auto copy = Compressor<T>::Deserialize(data);
+        REQUIRE(copy.GetPos() == fitted.GetPos());
+        equal(copy.GetTimeOrigin(), t2);
+    }
+    {
+        auto data = compress.Serialize();
+        REQUIRE_THROWS_AS(Compressor<T>::Deserialize(data.substr(0, data.size() - 1)),
+                          Compressor<T>::InvalidFormat);
+        REQUIRE_THROWS_AS(Compressor<T>::Deserialize(data.substr(0, 10)),
+                          Compressor<T>::InvalidFormat);
+        data[0] = 'x';
+        REQUIRE_THROWS_AS(Compressor<T>::Deserialize(data),
+                          Compressor<T>::InvalidFormat);
+        REQUIRE_THROWS_AS(Compressor<float>::Deserialize(compress.Serialize()),
+                          Compressor<float>::InvalidFormat);
+    }
+}
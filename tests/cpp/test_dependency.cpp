@@ -66,3 +66,29 @@ TEST_CASE("check dependency", "[measCompress, dependency]")
     REQUIRE_THROWS_AS(dep.Check(t, 3, 7),
                       Dependency<T>::IndexOutOfBounds);
 }
+
+TEST_CASE("check dependency error norm", "[measCompress, dependency]")
+{
+    using RelDependency = Dependency<T, RelMaxError<T>>;
+    using AbsRelDependency = Dependency<T, AbsRelMaxError<T>>;
+
+    std::vector<T> t = {1, 2, 3, 4, 5, 6};
+    std::vector<T> y = {100, 200, 300, 400, 500, 620};
+
+    REQUIRE(!Dependency<T>(y, T(5)).Check(t, 0, 6));
+    REQUIRE(RelDependency(y, T(0.1)).Check(t, 0, 6));
+    REQUIRE(!RelDependency(y, T(0.01)).Check(t, 0, 6));
+    REQUIRE(Dependency<T, RmsError<T>>(y, T(10)).Check(t, 0, 6));
+    REQUIRE(!Dependency<T, RmsError<T>>(y, T(5)).Check(t, 0, 6));
+    REQUIRE(AbsRelDependency(y, AbsRelMaxError<T>(T(5), T(0.1))).Check(t, 0, 6));
+    REQUIRE(!AbsRelDependency(y, AbsRelMaxError<T>(T(0), T(0.01))).Check(t, 0, 6));
+
+    REQUIRE_THROWS_AS(RelDependency(y, T(-0.1)),
+                      RelDependency::InvalidTolerance);
+    REQUIRE_THROWS_AS(AbsRelDependency(y, AbsRelMaxError<T>(T(0.1), T(-0.1))),
+                      AbsRelDependency::InvalidTolerance);
+
+    AnyDependency<T> dep = RelDependency(y, T(0.1));
+    REQUIRE(dep.GetSize() == 6);
+    REQUIRE(dep.Check(t, 0, 6));
+}
@@ -0,0 +1,58 @@
+#include "catch2/catch.hpp"
+#include "error_norm.hpp"
+
+#include <vector>
+#include <cmath>
+
+using namespace measCompress;
+using T = double;
+
+TEST_CASE("valid tolerance", "[measCompress, error_norm]")
+{
+    REQUIRE(AbsMaxError<T>(T(0)).IsValid());
+    REQUIRE(!AbsMaxError<T>(T(-0.1)).IsValid());
+    REQUIRE(RelMaxError<T>(T(0.1)).IsValid());
+    REQUIRE(!RelMaxError<T>(T(-0.1)).IsValid());
+    REQUIRE(RmsError<T>(T(0.1)).IsValid());
+    REQUIRE(!RmsError<T>(T(-0.1)).IsValid());
+    REQUIRE(AbsRelMaxError<T>(T(0), T(0.1)).IsValid());
+    REQUIRE(!AbsRelMaxError<T>(T(-0.1), T(0.1)).IsValid());
+    REQUIRE(!AbsRelMaxError<T>(T(0.1), T(-0.1)).IsValid());
+}
+
+TEST_CASE("check error norm", "[measCompress, error_norm]")
+{
+    // errors: 1, -0.5, 0, 0.5
+    Line<T> line(0, 0, 0);
+    std::vector<T> t = {1, 2, 3, 4};
+    std::vector<T> y = {1, -0.5, 0, 0.5};
+
+    // the tolerance is exclusive for all norms
+    const T above = std::nextafter(T(1), T(2));
+    REQUIRE(AbsMaxError<T>(above).Check(line, t, y));
+    REQUIRE(!AbsMaxError<T>(T(1)).Check(line, t, y));
+
+    // rms = sqrt(1.5 / 4)
+    REQUIRE(RmsError<T>(std::nextafter(std::sqrt(T(0.375)), T(1))).Check(line, t, y));
+    REQUIRE(!RmsError<T>(std::sqrt(T(0.375))).Check(line, t, y));
+
+    // the exact point y=0 is within a relative tolerance
+    REQUIRE(RelMaxError<T>(above).Check(line, t, y));
+    REQUIRE(!RelMaxError<T>(T(1)).Check(line, t, y));
+    std::vector<T> y0 = {1, -0.5, 0, 0.5};
+    REQUIRE(!RelMaxError<T>(T(2)).Check(Line<T>(0, 0, 0.1), t, y0));
+    REQUIRE(RelMaxError<T>(T(0)).Check(line, t, std::vector<T>(4, T(0))));
+    REQUIRE(AbsRelMaxError<T>(T(0), T(0)).Check(line, t, std::vector<T>(4, T(0))));
+    std::vector<T> y1 = {1, -0.5, 0.25, 0.5};
+    REQUIRE(RelMaxError<T>(above).Check(line, t, y1));
+    REQUIRE(!RelMaxError<T>(T(1)).Check(line, t, y1));
+
+    std::vector<T> y2 = {10, -0.5, 0, 100};
+    REQUIRE(!AbsRelMaxError<T>(T(0.5), T(0.9)).Check(line, t, y2));
+    REQUIRE(AbsRelMaxError<T>(T(0.5), T(1)).Check(line, t, y2));
+    REQUIRE(!AbsRelMaxError<T>(T(0), T(1)).Check(line, t, y2));
+
+    // without a relative part it is the absolute norm
+    REQUIRE(AbsRelMaxError<T>(above, T(0)).Check(line, t, y));
+    REQUIRE(!AbsRelMaxError<T>(T(1), T(0)).Check(line, t, y));
+}
@@ -0,0 +1,60 @@
+#include "catch2/catch.hpp"
+#include "progress.hpp"
+
+#include <vector>
+#include <utility>
+
+using namespace measCompress;
+
+TEST_CASE("cancel token", "[measCompress, progress]")
+{
+    CancelToken token;
+    CancelToken copy = token;
+    REQUIRE(!token.IsCancelled());
+    REQUIRE(!copy.IsCancelled());
+    copy.Cancel();
+    REQUIRE(token.IsCancelled());
+    REQUIRE(copy.IsCancelled());
+}
+
+TEST_CASE("progress", "[measCompress, progress]")
+{
+    {
+        Progress progress;
+        progress.Start().Update(3, 10);
+        REQUIRE(!progress.IsCancelled());
+    }
+    {
+        std::vector<std::pair<std::size_t, std::size_t>> calls;
+        CancelToken token;
+        Progress progress([&](std::size_t done, std::size_t total)
+                          { calls.emplace_back(done, total); },
+                          4, token);
+        auto reporter = progress.Start();
+        for (std::size_t done : {1, 3, 4, 6, 9, 10})
+            reporter.Update(done, 10);
+        REQUIRE(calls == std::vector<std::pair<std::size_t, std::size_t>>{
+                             {1, 10}, {6, 10}, {10, 10}});
+
+        // independent state per computation
+        calls.clear();
+        auto first = progress.Start();
+        auto second = progress.Start();
+        first.Update(2, 10);
+        second.Update(3, 10);
+        first.Update(5, 10);
+        second.Update(5, 10);
+        REQUIRE(calls == std::vector<std::pair<std::size_t, std::size_t>>{
+                             {2, 10}, {3, 10}});
+
+        REQUIRE(!progress.IsCancelled());
+        token.Cancel();
+        REQUIRE(progress.IsCancelled());
+    }
+    {
+        CancelToken token;
+        Progress progress(token);
+        token.Cancel();
+        REQUIRE(progress.IsCancelled());
+    }
+}
@@ -0,0 +1,73 @@
+#include "catch2/catch.hpp"
+#include "reader.hpp"
+
+#include <vector>
+#include <sstream>
+
+using namespace measCompress;
+using T = double;
+
+TEST_CASE("read csv", "[measCompress, reader]")
+{
+    {
+        std::istringstream in("");
+        REQUIRE_THROWS_AS(CsvReader<T>(in), CsvReader<T>::MissingHeader);
+    }
+    {
+        std::istringstream in("t, y1 ,y2\r\n0,1,2\r\n1, 2.5 ,-3e2\n\n2,+4,5\n3,6,7\n");
+        CsvReader<T> reader(in);
+        REQUIRE(reader.GetNames() == std::vector<std::string>{"t", "y1", "y2"});
+
+        std::vector<std::vector<T>> columns;
+        REQUIRE(reader.Read(columns, 3) == 3);
+        REQUIRE(columns == std::vector<std::vector<T>>{{0, 1, 2}, {1, 2.5, 4}, {2, -300, 5}});
+
+        REQUIRE(reader.Read(columns, 3) == 1);
+        REQUIRE(columns[0] == std::vector<T>{0, 1, 2, 3});
+        REQUIRE(reader.Read(columns, 3) == 0);
+    }
+    {
+        std::istringstream in("t;y\n0;1\n1;2");
+        CsvReader<T> reader(in, ';');
+        std::vector<std::vector<T>> columns;
+        REQUIRE(reader.Read(columns, 10) == 2);
+        REQUIRE(columns == std::vector<std::vector<T>>{{0, 1}, {1, 2}});
+    }
+    for (auto str : {"t,y\n0,1,2\n", "t,y\n0\n", "t,y\n0,a\n", "t,y\n0,,1\n"})
+    {
+        std::istringstream in(str);
+        CsvReader<T> reader(in);
+        std::vector<std::vector<T>> columns;
+        REQUIRE_THROWS_AS(reader.Read(columns, 10), CsvReader<T>::ParseError);
+    }
+}
+
+TEST_CASE("read binary", "[measCompress, reader]")
+{
+    {
+        std::istringstream in("");
+        REQUIRE_THROWS_AS(BinaryReader<T>(in, 0), BinaryReader<T>::InvalidSize);
+    }
+    {
+        std::vector<T> data = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+        std::istringstream in(std::string(reinterpret_cast<const char *>(data.data()),
+                                          data.size() * sizeof(T)));
+        BinaryReader<T> reader(in, 3);
+        REQUIRE(reader.GetNames() == std::vector<std::string>{"0", "1", "2"});
+
+        std::vector<std::vector<T>> columns;
+        REQUIRE(reader.Read(columns, 2) == 2);
+        REQUIRE(columns == std::vector<std::vector<T>>{{0, 3}, {1, 4}, {2, 5}});
+        REQUIRE(reader.Read(columns, 2) == 1);
+        REQUIRE(columns == std::vector<std::vector<T>>{{0, 3, 6}, {1, 4, 7}, {2, 5, 8}});
+        REQUIRE(reader.Read(columns, 2) == 0);
+    }
+    {
+        std::vector<T> data = {0, 1, 2, 3};
+        std::istringstream in(std::string(reinterpret_cast<const char *>(data.data()),
+                                          data.size() * sizeof(T)));
+        BinaryReader<T> reader(in, 3);
+        std::vector<std::vector<T>> columns;
+        REQUIRE_THROWS_AS(reader.Read(columns, 2), BinaryReader<T>::Truncated);
+    }
+}
@@ -0,0 +1,158 @@
+#include "catch2/catch.hpp"
+#include "residual.hpp"
+
+#include <vector>
+#include <cmath>
+
+using namespace measCompress;
+using T = double;
+
+namespace
+{
+    std::vector<T> gen_data(std::size_t n)
+    {
+        std::vector<T> y(n);
+        for (std::size_t i = 0; i < n; ++i)
+            y[i] = T((i / 100) % 2) + 0.01 * std::sin(T(i) * 0.37) + 1e-3 * T(i % 7);
+        return y;
+    }
+}
+
+TEST_CASE("encode residual", "[measCompress, residual]")
+{
+    std::vector<T> t = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<T> y = {0, 1.1, 2.1, 3, 3, 3, 3, 1.9, 0.9, 0};
+    Dependency<T> dep1(y, T(0.2));
+    auto compress = Compressor<T>().Fit(t, {dep1});
+    auto y_fit = compress.Transform(y);
+
+    REQUIRE_THROWS_AS(Residual<T>::Encode(compress, y, y_fit, T(-0.1)),
+                      Residual<T>::InvalidTolerance);
+    REQUIRE_THROWS_AS(Residual<T>::Encode(compress, y, {1, 2}),
+                      Residual<T>::InvalidSize);
+    REQUIRE_THROWS_AS(Residual<T>::Encode(compress, {1, 2, 3}, y_fit),
+                      Residual<T>::InvalidSize);
+    {
+        std::vector<T> y_nan = y;
+        y_nan[4] = std::nan("");
+        // lossless encoding supports every value
+        auto residual = Residual<T>::Encode(compress, y_nan, y_fit);
+        REQUIRE(std::isnan(residual.Decode(compress, y_fit)[4]));
+
+        // the segment with the value is stored lossless
+        residual = Residual<T>::Encode(compress, y_nan, y_fit, T(0.1));
+        auto y_dec = residual.Decode(compress, y_fit);
+        REQUIRE(std::isnan(y_dec[4]));
+        for (std::size_t i = 0; i < y.size(); ++i)
+            if (i != 4)
+                REQUIRE(std::abs(y_dec[i] - y[i]) <= T(0.1));
+    }
+
+    auto residual = Residual<T>::Encode(compress, y, y_fit);
+    REQUIRE(residual.GetMaxError() == T(0));
+    REQUIRE(residual.Decode(compress, y_fit) == y);
+    REQUIRE_THROWS_AS(residual.Decode(compress, {1, 2}),
+                      Residual<T>::InvalidSize);
+    REQUIRE_THROWS_AS(residual.Decode(Compressor<T>(t, {0, 9}), {1, 2}),
+                      Residual<T>::InvalidSize);
+}
+
+TEST_CASE("encode residual around zero", "[measCompress, residual]")
+{
+    // the prediction is +0, the values have both signs
+    std::vector<T> t = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<T> y = {-0.0, 0, -1e-320, 1e-320, -2e-320, 2e-320, -0.0, 5e-321, -5e-321, 0};
+    Compressor<T> compress(t, {0, 9});
+    std::vector<T> y_fit = {0, 0};
+
+    auto residual = Residual<T>::Encode(compress, y, y_fit);
+    REQUIRE(residual.GetBytes() < y.size() * sizeof(T) / 2);
+    auto y_dec = residual.Decode(compress, y_fit);
+    for (std::size_t i = 0; i < y.size(); ++i)
+    {
+        REQUIRE(y_dec[i] == y[i]);
+        REQUIRE(std::signbit(y_dec[i]) == std::signbit(y[i]));
+    }
+}
+
+TEST_CASE("bounded residual at the resolution of the values", "[measCompress, residual]")
+{
+    // max_error close to the spacing of the values (1.2e-10), the rounding
+    // of the decoded value matters
+    std::vector<T> t(1000);
+    for (std::size_t i = 0; i < t.size(); ++i)
+        t[i] = T(i);
+    auto y = gen_data(t.size());
+    for (auto &yi : y)
+        yi = 1e6 + 1e3 * yi;
+
+    Dependency<T> dep1(y, T(10));
+    auto compress = Compressor<T>().Fit(t, {dep1});
+    auto y_fit = compress.Transform(y);
+    for (T max_error : {T(1e-10), T(1.5e-10), T(3e-10), T(1e-9), T(1e-8)})
+    {
+        auto residual = Residual<T>::Encode(compress, y, y_fit, max_error);
+        auto y_dec = residual.Decode(compress, y_fit);
+        for (std::size_t i = 0; i < y.size(); ++i)
+            REQUIRE(std::abs(y_dec[i] - y[i]) <= max_error);
+    }
+}
+
+TEST_CASE("decode residual", "[measCompress, residual]")
+{
+    std::vector<T> t(10000);
+    for (std::size_t i = 0; i < t.size(); ++i)
+        t[i] = T(i) * 0.01;
+    auto y = gen_data(t.size());
+
+    Dependency<T> dep1(y, T(0.1));
+    auto compress = Compressor<T>().Fit(t, {dep1});
+    REQUIRE(compress.GetPos().size() > 10);
+
+    for (auto y_fit : {compress.Transform(y), compress.TransformContinuous(y)})
+    {
+        for (std::size_t n_threads : {1, 4})
+        {
+            auto residual = Residual<T>::Encode(compress, y, y_fit, T(0), n_threads);
+            REQUIRE(residual.GetBytes() < y.size() * sizeof(T));
+            REQUIRE(residual.Decode(compress, y_fit, n_threads) == y);
+            REQUIRE(residual.Decode(compress, y_fit, 3) == y);
+        }
+
+        for (T max_error : {T(1e-6), T(1e-3)})
+        {
+            auto residual = Residual<T>::Encode(compress, y, y_fit, max_error, 2);
+            REQUIRE(residual.GetMaxError() == Approx(max_error));
+            REQUIRE(residual.GetBytes() < y.size() * sizeof(T) / 2);
+
+            auto y_dec = residual.Decode(compress, y_fit);
+            REQUIRE(y_dec.size() == y.size());
+            for (std::size_t i = 0; i < y.size(); ++i)
+                REQUIRE(std::abs(y_dec[i] - y[i]) <= max_error);
+        }
+    }
+}
+
+TEST_CASE("serialize residual", "[measCompress, residual]")
+{
+    std::vector<T> t(1000);
+    for (std::size_t i = 0; i < t.size(); ++i)
+        t[i] = T(i);
+    auto y = gen_data(t.size());
+
+    Dependency<T> dep1(y, T(0.1));
+    auto compress = Compressor<T>().Fit(t, {dep1});
+    auto y_fit = compress.Transform(y);
+    auto residual = Residual<T>::Encode(compress, y, y_fit, T(1e-4));
+
+    auto data = residual.Serialize();
+    auto copy = Residual<T>::Deserialize(data);
+    REQUIRE(copy.GetMaxError() == residual.GetMaxError());
+    REQUIRE(copy.Decode(compress, y_fit) == residual.Decode(compress, y_fit));
+
+    REQUIRE_THROWS_AS(Residual<T>::Deserialize(data.substr(0, data.size() - 1)),
+                      Residual<T>::InvalidFormat);
+    data[0] = 'x';
+    REQUIRE_THROWS_AS(Residual<T>::Deserialize(data),
+                      Residual<T>::InvalidFormat);
+}
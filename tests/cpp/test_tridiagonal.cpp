@@ -0,0 +1,50 @@
+#include "catch2/catch.hpp"
+#include "tridiagonal.hpp"
+
+#include <vector>
+
+using namespace measCompress;
+using T = double;
+
+TEST_CASE("constructor tridiagonal", "[measCompress, tridiagonal]")
+{
+    REQUIRE_THROWS_AS(Tridiagonal<T>({}, {}, {}),
+                      Tridiagonal<T>::InvalidSize);
+    REQUIRE_THROWS_AS(Tridiagonal<T>({1}, {1, 2}, {}),
+                      Tridiagonal<T>::InvalidSize);
+    REQUIRE_THROWS_AS(Tridiagonal<T>({1}, {1, 1}, {1}),
+                      Tridiagonal<T>::Singular);
+    REQUIRE(Tridiagonal<T>({}, {2}, {}).GetSize() == 1);
+}
+
+TEST_CASE("solve tridiagonal", "[measCompress, tridiagonal]")
+{
+    {
+        Tridiagonal<T> system({}, {2}, {});
+        std::vector<T> x = {3};
+        system.Solve(x);
+        REQUIRE(x[0] == Approx(T(1.5)));
+    }
+    {
+        // A = [[2, 1, 0, 0], [-1, 4, 2, 0], [0, 1, 3, 1], [0, 0, 2, 5]]
+        // x = [1, 2, 3, 4]
+        Tridiagonal<T> system({-1, 1, 2}, {2, 4, 3, 5}, {1, 2, 1});
+        std::vector<T> x = {4, 13, 15, 26};
+        system.Solve(x);
+        REQUIRE(x[0] == Approx(T(1)));
+        REQUIRE(x[1] == Approx(T(2)));
+        REQUIRE(x[2] == Approx(T(3)));
+        REQUIRE(x[3] == Approx(T(4)));
+
+        // reuse the factorization
+        std::vector<T> x2 = {2, -1, 0, 0};
+        system.Solve(x2);
+        REQUIRE(x2[0] == Approx(T(1)));
+        REQUIRE(x2[1] == Approx(T(0)).margin(1e-12));
+        REQUIRE(x2[2] == Approx(T(0)).margin(1e-12));
+        REQUIRE(x2[3] == Approx(T(0)).margin(1e-12));
+
+        std::vector<T> x3 = {1, 2, 3};
+        REQUIRE_THROWS_AS(system.Solve(x3), Tridiagonal<T>::InvalidSize);
+    }
+}
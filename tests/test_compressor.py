@@ -1,6 +1,7 @@
 # pylint: disable=missing-module-docstring, missing-function-docstring
+import pickle
 import pytest
-from MeasCompress import Compressor, Dependency
+from MeasCompress import Compressor, Dependency, CancelToken, Cancelled
 
 
 def allclose(a, b):
@@ -54,3 +55,138 @@ def test_fit():
     assert allclose(compress.Transform(y), [0.05, 3.025, 2.975, -0.05])
     assert allclose(compress.TransformNoFit(y), [0, 3, 3, 0])
     assert allclose(compress.TransformNoFit(t), compress.GetTimeFit())
+
+
+def test_fit_norm():
+    t = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9]
+    y1 = [0, 1, 2, 3, 3, 3, 3, 2, 1, 0]
+    y2 = [1, 2, 4, 8, 16, 32, 64, 128, 256, 512]
+    dep1 = Dependency(y1, 0.1)
+    dep2 = Dependency(y2, 0.5, norm='rel')
+    assert list(Compressor().Fit(t, [dep1]).GetPos()) == [0, 3, 6, 9]
+    assert list(Compressor().Fit(t, [dep2]).GetPos()) == [0, 2, 4, 6, 8, 9]
+    compress = Compressor().Fit(t, [dep1, dep2])
+    assert list(compress.GetPos()) == [0, 2, 3, 5, 6, 8, 9]
+
+
+def test_transform_continuous():
+    t = [1, 2, 3, 4, 5, 6, 7, 8, 9, 10]
+    y1 = [1, 2, 3, 4, 4, 4, 4, 3, 2, 1]
+    y2 = [0, 1.1, 2.1, 3, 3, 3, 3, 1.9, 0.9, 0]
+    compress = Compressor().Fit(t, [Dependency(y1, 0.1)])
+    assert allclose(compress.GetTimeFit(), [1, 4, 7, 10])
+    assert allclose(compress.TransformContinuous(y1), [1, 4, 4, 1])
+    assert allclose(compress.TransformContinuous(y2),
+                    [0.0510309278350515, 3.046391752577319,
+                     2.953608247422681, -0.0510309278350515])
+
+    result = compress.TransformContinuous([y1, y2])
+    assert len(result) == 2
+    assert allclose(result[0], compress.TransformContinuous(y1))
+    assert allclose(result[1], compress.TransformContinuous(y2))
+
+
+def test_progress():
+    t = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9]
+    y = [0, 1, 2, 3, 3, 3, 3, 2, 1, 0]
+    dep = Dependency(y, 0.1)
+
+    done = []
+    compress = Compressor().Fit(t, [dep], progress=lambda d, n: done.append(d),
+                                progress_step=1)
+    assert allclose(compress.GetTimeFit(), [0, 3, 6, 9])
+    assert done and done[-1] == 10
+    assert sorted(done) == done
+
+    done = []
+    assert allclose(compress.Transform(y, progress=lambda d, n: done.append(d),
+                                       progress_step=1), [0, 3, 3, 0])
+    assert done == [4, 7, 10]
+
+    cancel = CancelToken()
+    assert not cancel.IsCancelled()
+    cancel.Cancel()
+    assert cancel.IsCancelled()
+    with pytest.raises(Cancelled):
+        Compressor().Fit(t, [dep], cancel=cancel)
+    with pytest.raises(Cancelled):
+        compress.Transform(y, cancel=cancel)
+    with pytest.raises(Cancelled):
+        compress.TransformContinuous(y, cancel=cancel)
+
+    done = []
+    compress.TransformContinuous([y, y], progress=lambda d, n: done.append((d, n)),
+                                 progress_step=1)
+    assert done == [(10, 30), (20, 30), (30, 30)]
+
+
+def test_fit_parallel():
+    t = [i * 0.1 for i in range(2000)]
+    y = [i if i < 1000 else 1000 - 0.5 * (i - 1000) for i in range(2000)]
+    dep = Dependency(y, 0.1)
+    sequential = Compressor().Fit(t, [dep])
+    assert list(sequential.GetPos()) == [0, 1000, 1999]
+    for n_threads in (0, 2, 4):
+        parallel = Compressor().SetParallel(n_threads, 16).Fit(t, [dep])
+        assert list(parallel.GetPos()) == [0, 1000, 1999]
+
+
+def test_serialize():
+    t = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9]
+    y = [0, 1.1, 2.1, 3, 3, 3, 3, 1.9, 0.9, 0]
+    compress = Compressor().Fit(t, [Dependency(y, 0.1)])
+    assert list(compress.GetPos()) == [0, 3, 6, 9]
+
+    copy = Compressor(t, [0, 3, 6, 9])
+    assert allclose(copy.Transform(y), [0.05, 3.025, 2.975, -0.05])
+    with pytest.raises(RuntimeError):
+        Compressor(t, [0, 3, 6])
+
+    grid = Compressor.FromGrid(0, 1, 10, [0, 3, 6, 9])
+    assert allclose(grid.GetTimeOrigin(), t)
+
+    copy = Compressor.Deserialize(compress.Serialize())
+    assert list(copy.GetPos()) == [0, 3, 6, 9]
+    assert allclose(copy.GetTimeOrigin(), t)
+
+    data = compress.Serialize(with_time=False)
+    with pytest.raises(RuntimeError):
+        Compressor.Deserialize(data)
+    copy = Compressor.Deserialize(data, t)
+    assert allclose(copy.Transform(y), [0.05, 3.025, 2.975, -0.05])
+
+    for obj in (compress, grid):
+        copy = pickle.loads(pickle.dumps(obj))
+        assert list(copy.GetPos()) == [0, 3, 6, 9]
+        assert allclose(copy.GetTimeOrigin(), t)
+
+    # the equidistant time of the fit is stored as t0 and dt
+    assert compress.Serialize() == grid.Serialize()
+
+    with pytest.raises(RuntimeError):
+        Compressor.Deserialize(grid.Serialize(), max_grid_size=9)
+    assert list(Compressor.Deserialize(grid.Serialize(),
+                                       max_grid_size=10).GetPos()) == [0, 3, 6, 9]
+
+    # not fitted, and the settings of the parallel fit
+    copy = pickle.loads(pickle.dumps(Compressor().SetParallel(3, 100)))
+    assert len(copy.GetPos()) == 0
+    assert copy.GetThreads() == 3 and copy.GetParallelMinSize() == 100
+
+
+def test_serialize_without_time():
+    t = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9.5]
+    y = [0, 1.1, 2.1, 3, 3, 3, 3, 1.9, 0.9, 0]
+    compress = Compressor().Fit(t, [Dependency(y, 0.1)])
+
+    data = compress.Serialize(with_time=False)
+    assert len(data) < len(compress.Serialize())
+    copy = Compressor.Deserialize(data, t)
+    assert list(copy.GetPos()) == list(compress.GetPos())
+    assert allclose(copy.GetTimeOrigin(), t)
+    assert allclose(copy.Transform(y), compress.Transform(y))
+    with pytest.raises(RuntimeError):
+        Compressor.Deserialize(data, t[:-1])
+
+    copy = pickle.loads(pickle.dumps(compress))
+    assert allclose(copy.GetTimeOrigin(), t)
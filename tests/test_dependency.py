@@ -14,3 +14,22 @@ def test_constructor():
 
     Dependency([1, 2], 0)
     Dependency([1, 2], 0.1)
+
+
+def test_norm():
+
+    with pytest.raises(ValueError):
+        Dependency([1, 2], 0.1, norm='unknown')
+    with pytest.raises(RuntimeError):
+        Dependency([1, 2], -0.1, norm='rel')
+    with pytest.raises(RuntimeError):
+        Dependency([1, 2], 0.1, norm='absrel', rtol=-0.1)
+    with pytest.raises(ValueError):
+        Dependency([1, 2], 0.1, norm='rel', rtol=0.01)
+    with pytest.raises(ValueError):
+        Dependency([1, 2], 0.1, rtol=0.01)
+
+    Dependency([1, 2], 0.1, norm='abs')
+    Dependency([1, 2], 0.1, norm='rel')
+    Dependency([1, 2], 0.1, norm='rms')
+    Dependency([1, 2], 0.1, norm='absrel', rtol=0.01)
@@ -0,0 +1,45 @@
+# pylint: disable=missing-module-docstring, missing-function-docstring
+import math
+import pickle
+import pytest
+from MeasCompress import Compressor, Dependency, Residual
+
+
+def gen_data(n):
+    t = [i * 0.01 for i in range(n)]
+    y = [(i // 100) % 2 + 0.01 * math.sin(i * 0.37) for i in range(n)]
+    return t, y
+
+
+def test_encode():
+    t, y = gen_data(1000)
+    compress = Compressor().Fit(t, [Dependency(y, 0.1)])
+    y_fit = compress.Transform(y)
+
+    with pytest.raises(RuntimeError):
+        Residual.Encode(compress, y, y_fit, max_error=-0.1)
+    with pytest.raises(RuntimeError):
+        Residual.Encode(compress, y, [1, 2])
+
+    residual = Residual.Encode(compress, y, y_fit)
+    assert residual.GetMaxError() == 0
+    assert residual.GetBytes() < 8 * len(y)
+    assert residual.Decode(compress, y_fit) == y
+
+    residual = Residual.Encode(compress, y, y_fit, max_error=1e-4,
+                               n_threads=2)
+    assert residual.GetBytes() < 4 * len(y)
+    y_dec = residual.Decode(compress, y_fit, n_threads=2)
+    assert all(abs(a - b) <= 1e-4 for a, b in zip(y, y_dec))
+
+
+def test_serialize():
+    t, y = gen_data(1000)
+    compress = Compressor().Fit(t, [Dependency(y, 0.1)])
+    y_fit = compress.Transform(y)
+    residual = Residual.Encode(compress, y, y_fit)
+
+    copy = Residual.Deserialize(residual.Serialize())
+    assert copy.Decode(compress, y_fit) == y
+    copy = pickle.loads(pickle.dumps(residual))
+    assert copy.Decode(compress, y_fit) == y